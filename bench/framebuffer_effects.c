@@ -0,0 +1,172 @@
+// Host micro-benchmark for the framebuffer effect kernels in src/util/framebuffer_kernels.h.
+//
+//   cc -O2 -fno-tree-vectorize -Isrc -o framebuffer_effects bench/framebuffer_effects.c
+//   ./framebuffer_effects
+//
+// Checks each kernel against a per-pixel reference on random rows and rects,
+// then times full-screen effects against the previous per-byte inverter loop.
+// Vectorization is disabled to approximate the scalar Cortex-M cores of the watches;
+// with it enabled the host compiler turns the per-byte loop into SIMD as well.
+
+#include "util/framebuffer_kernels.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define WIDTH 144
+#define HEIGHT 168
+#define ROW_SIZE_1BIT 20
+#define ITERATIONS 2000
+
+static uint8_t s_frame8[HEIGHT * WIDTH];
+static uint8_t s_frame1[HEIGHT * ROW_SIZE_1BIT];
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void fill_random(uint8_t *data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    data[i] = rand();
+  }
+}
+
+// The per-pixel inverter loop that the kernels replace
+static void reference_invert_loop(uint8_t *data, int16_t min_x, int16_t min_y, int16_t max_x,
+                                  int16_t max_y) {
+  data += WIDTH * min_y;
+  for (int16_t y = min_y; y < max_y; y++) {
+    for (int16_t x = min_x; x < max_x; x++) {
+      data[x] = ~data[x];
+    }
+    data += WIDTH;
+  }
+}
+
+static uint8_t reference_pixel8(int effect, uint8_t pixel, uint8_t tint) {
+  uint8_t out = pixel & 0xC0;
+  for (int shift = 0; shift < 6; shift += 2) {
+    const int c = (pixel >> shift) & 3;
+    const int t = (tint >> shift) & 3;
+    const int v = (effect == 0) ? (3 - c) : (effect == 1) ? (c >> 1) : ((c + t) >> 1);
+    out |= v << shift;
+  }
+  return out;
+}
+
+static bool check_kernels(void) {
+  static const FbKernelSpan spans8[] = { fb_kernel_invert8_span, fb_kernel_dim8_span, fb_kernel_tint8_span };
+  uint8_t row[WIDTH + 8];
+  uint8_t expect[WIDTH + 8];
+
+  for (int trial = 0; trial < 10000; trial++) {
+    const int effect = trial % 3;
+    const uint8_t tint = rand();
+    const int16_t min_x = rand() % WIDTH;
+    const int16_t end_x = min_x + rand() % (WIDTH - min_x + 1);
+    const int offset = rand() % 4;
+    fill_random(row, sizeof(row));
+    memcpy(expect, row, sizeof(row));
+    for (int16_t x = min_x; x < end_x; x++) {
+      expect[offset + x] = reference_pixel8(effect, expect[offset + x], tint);
+    }
+    fb_kernel_row8(spans8[effect], row + offset, min_x, end_x, fb_kernel_splat(tint));
+    if (memcmp(row, expect, sizeof(row)) != 0) {
+      printf("8-bit effect %d failed for [%d, %d) at offset %d\n", effect, min_x, end_x, offset);
+      return false;
+    }
+  }
+
+  static const FbKernelSpan spans1[] = { fb_kernel_invert1_span, fb_kernel_and1_span, fb_kernel_or1_span };
+  for (int trial = 0; trial < 10000; trial++) {
+    const int effect = trial % 3;
+    const uint32_t arg = (trial & 1) ? 0xAAAAAAAAu : 0x55555555u;
+    const int16_t min_x = rand() % WIDTH;
+    const int16_t end_x = min_x + rand() % (WIDTH - min_x + 1);
+    fill_random(row, ROW_SIZE_1BIT);
+    memcpy(expect, row, ROW_SIZE_1BIT);
+    for (int16_t x = min_x; x < end_x; x++) {
+      const uint8_t bit = 1 << (x & 7);
+      const bool pattern = (arg >> (x & 31)) & 1;
+      bool value = expect[x >> 3] & bit;
+      value = (effect == 0) ? !value : (effect == 1) ? (value && pattern) : (value || pattern);
+      expect[x >> 3] = value ? (expect[x >> 3] | bit) : (expect[x >> 3] & ~bit);
+    }
+    fb_kernel_row1(spans1[effect], row, min_x, end_x, arg);
+    if (memcmp(row, expect, ROW_SIZE_1BIT) != 0) {
+      printf("1-bit effect %d failed for [%d, %d)\n", effect, min_x, end_x);
+      return false;
+    }
+  }
+  return true;
+}
+
+typedef void (*FrameEffect)(void);
+
+static void frame_reference_invert(void) {
+  reference_invert_loop(s_frame8, 0, 0, WIDTH, HEIGHT);
+}
+
+#define DEFINE_FRAME_EFFECT8(name, span, arg)                          \
+  static void name(void) {                                             \
+    for (int16_t y = 0; y < HEIGHT; y++) {                             \
+      fb_kernel_row8(span, s_frame8 + y * WIDTH, 0, WIDTH, arg);       \
+    }                                                                  \
+  }
+
+#define DEFINE_FRAME_EFFECT1(name, span)                               \
+  static void name(void) {                                             \
+    for (int16_t y = 0; y < HEIGHT; y++) {                             \
+      fb_kernel_row1(span, s_frame1 + y * ROW_SIZE_1BIT, 0, WIDTH,     \
+                     (y & 1) ? 0xAAAAAAAAu : 0x55555555u);             \
+    }                                                                  \
+  }
+
+DEFINE_FRAME_EFFECT8(frame_invert8, fb_kernel_invert8_span, 0)
+DEFINE_FRAME_EFFECT8(frame_dim8, fb_kernel_dim8_span, 0)
+DEFINE_FRAME_EFFECT8(frame_tint8, fb_kernel_tint8_span, fb_kernel_splat(0xF0))
+DEFINE_FRAME_EFFECT1(frame_invert1, fb_kernel_invert1_span)
+DEFINE_FRAME_EFFECT1(frame_dim1, fb_kernel_and1_span)
+
+static double measure(FrameEffect effect) {
+  const double start = now_ns();
+  for (int i = 0; i < ITERATIONS; i++) {
+    effect();
+    __asm__ __volatile__("" ::: "memory");
+  }
+  return (now_ns() - start) / ITERATIONS;
+}
+
+int main(void) {
+  srand(1);
+  if (!check_kernels()) {
+    return 1;
+  }
+  printf("kernels match the per-pixel reference\n");
+
+  fill_random(s_frame8, sizeof(s_frame8));
+  fill_random(s_frame1, sizeof(s_frame1));
+
+  static const struct {
+    const char *name;
+    FrameEffect effect;
+  } cases[] = {
+    { "per-byte invert (previous)", frame_reference_invert },
+    { "8-bit invert", frame_invert8 },
+    { "8-bit dim", frame_dim8 },
+    { "8-bit tint", frame_tint8 },
+    { "1-bit invert", frame_invert1 },
+    { "1-bit dim", frame_dim1 },
+  };
+
+  printf("%dx%d full frame, %d iterations\n", WIDTH, HEIGHT, ITERATIONS);
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    printf("  %-28s %9.0f ns/frame\n", cases[i].name, measure(cases[i].effect));
+  }
+  return 0;
+}
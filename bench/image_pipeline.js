@@ -0,0 +1,314 @@
+// Node benchmark for the image pipeline in src/js/lib/image.js.
+//
+//   node bench/image_pipeline.js
+//
+// Scales a synthetic 288x336 photo down to a 144x168 screen image and quantizes it, once with the
+// previous separate greyscale, resize, dither and encode passes over plain arrays, and once with
+// the fused typed array pass. Checks that both pick the same pixels for undithered 1-bit, where the
+// quantizer is unchanged, then times them and reports the bytes each encoding would send. Quality
+// is the RMS difference of a 3x3 box blur of the output against the source, lower is better.
+// Bytes are the encoded size, a PNG for color, which is what the watch is sent.
+
+var path = require('path');
+
+// lib/image and its vendored dependencies resolve modules from src/js and expect a window
+global.window = global;
+process.env.NODE_PATH = path.join(__dirname, '..', 'src', 'js');
+require('module')._initPaths();
+
+var image = require('lib/image');
+var PNGEncoder = require('lib/png-encoder');
+
+var SRC_WIDTH = 288;
+var SRC_HEIGHT = 336;
+var WIDTH = 144;
+var HEIGHT = 168;
+var ITERATIONS = 20;
+
+var makePhoto = function() {
+  var pixels = new Uint8Array(SRC_WIDTH * SRC_HEIGHT * 4);
+  var seed = 1;
+  var random = function() {
+    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+    return seed / 0x7FFFFFFF;
+  };
+  for (var y = 0; y < SRC_HEIGHT; ++y) {
+    for (var x = 0; x < SRC_WIDTH; ++x) {
+      var pos = (y * SRC_WIDTH + x) * 4;
+      var noise = random() * 24 - 12;
+      pixels[pos    ] = Math.max(0, Math.min(255, x * 255 / SRC_WIDTH + noise));
+      pixels[pos + 1] = Math.max(0, Math.min(255, y * 255 / SRC_HEIGHT + noise));
+      pixels[pos + 2] = Math.max(0, Math.min(255, 128 + 127 * Math.sin((x + y) / 24) + noise));
+      pixels[pos + 3] = 255;
+    }
+  }
+  return pixels;
+};
+
+// The pipeline that the fused pass replaces, kept as a reference
+
+var getPos = function(width, x, y) {
+  return y * width * 4 + x * 4;
+};
+
+var previous = {};
+
+previous.greyscale = function(pixels, width, height) {
+  for (var y = 0; y < height; ++y) {
+    for (var x = 0; x < width; ++x) {
+      var pos = getPos(width, x, y);
+      var grey = ((pixels[pos] + pixels[pos + 1] + pixels[pos + 2]) / 3) & 0xFF;
+      for (var i = 0; i < 3; ++i) {
+        pixels[pos + i] = grey;
+      }
+    }
+  }
+};
+
+previous.resizeSample = function(pixels, width, height, newWidth, newHeight) {
+  var newPixels = new Array(newWidth * newHeight * 4);
+  var widthRatio = width / newWidth;
+  var heightRatio = height / newHeight;
+  for (var y = 0; y < newHeight; ++y) {
+    for (var x = 0; x < newWidth; ++x) {
+      var x2 = Math.min(parseInt(x * widthRatio), width - 1);
+      var y2 = Math.min(parseInt(y * heightRatio), height - 1);
+      var pos = getPos(newWidth, x, y);
+      for (var i = 0; i < 4; ++i) {
+        newPixels[pos + i] = ((pixels[getPos(width, x2  , y2  ) + i] +
+                               pixels[getPos(width, x2+1, y2  ) + i] +
+                               pixels[getPos(width, x2  , y2+1) + i] +
+                               pixels[getPos(width, x2+1, y2+1) + i]) / 4) & 0xFF;
+      }
+    }
+  }
+  return newPixels;
+};
+
+previous.dither = function(pixels, width, height, dithers, converter) {
+  for (var y = 0; y < height; ++y) {
+    for (var x = 0; x < width; ++x) {
+      var pos = getPos(width, x, y);
+      for (var i = 0; i < 3; ++i) {
+        var oldColor = pixels[pos + i];
+        var newColor = converter(oldColor);
+        var error = oldColor - newColor;
+        pixels[pos + i] = newColor;
+        for (var j = 0; j < dithers.length; ++j) {
+          var dither = dithers[j];
+          var x2 = x + dither[0], y2 = y + dither[1];
+          if (x2 >= 0 && x2 < width && y < height) {
+            pixels[getPos(width, x2, y2) + i] += parseInt(error * dither[2]);
+          }
+        }
+      }
+    }
+  }
+};
+
+var getChannelGrey = function(color) {
+  return color >= 128 ? 255 : 0;
+};
+
+var getChannel2 = function(color) {
+  return Math.min(Math.max(parseInt(color / 64 + 0.5), 0) * 64, 255);
+};
+
+var getPixelColorUint8 = function(pixels, pos) {
+  var r = Math.min(Math.max(parseInt(pixels[pos    ] / 64 + 0.5), 0), 3);
+  var g = Math.min(Math.max(parseInt(pixels[pos + 1] / 64 + 0.5), 0), 3);
+  var b = Math.min(Math.max(parseInt(pixels[pos + 2] / 64 + 0.5), 0), 3);
+  return (0x3 << 6) | (r << 4) | (g << 2) | b;
+};
+
+//! The GColor8 that each pixel ends up as on the watch
+previous.toColors = function(pixels, bitdepth) {
+  var colors = [];
+  for (var i = 0; i < WIDTH * HEIGHT; ++i) {
+    var pos = i * 4;
+    if (bitdepth === 1) {
+      colors[i] = (pixels[pos] + pixels[pos + 1] + pixels[pos + 2]) / (3 * 255) >= 0.5 ? 0xFF : 0xC0;
+    } else {
+      colors[i] = getPixelColorUint8(pixels, pos);
+    }
+  }
+  return colors;
+};
+
+previous.toGbitmap1 = function(pixels, width, height) {
+  var growBytes = Math.ceil(width / 32) * 4;
+  var gpixels = [];
+  for (var i = 0; i < height * growBytes; ++i) {
+    gpixels[i] = 0;
+  }
+  for (var y = 0; y < height; ++y) {
+    for (var x = 0; x < width; ++x) {
+      var pos = getPos(width, x, y);
+      var grey = (pixels[pos] + pixels[pos + 1] + pixels[pos + 2]) / (3 * 255);
+      if (grey >= 0.5) {
+        gpixels[y * growBytes + parseInt(x / 8)] += 1 << (x % 8);
+      }
+    }
+  }
+  return gpixels;
+};
+
+previous.toPng8 = function(pixels, width, height) {
+  var raster = [];
+  for (var y = 0; y < height; ++y) {
+    var row = raster[y] = [];
+    for (var x = 0; x < width; ++x) {
+      var pos = getPos(width, x, y);
+      row[x] = [pixels[pos], pixels[pos + 1], pixels[pos + 2]];
+    }
+  }
+  var palette = [];
+  var colorMap = {};
+  for (var y2 = 0; y2 < height; ++y2) {
+    for (var x2 = 0; x2 < width; ++x2) {
+      var color = raster[y2][x2];
+      var hash = getPixelColorUint8(color, 0);
+      if (!(hash in colorMap)) {
+        colorMap[hash] = palette.length;
+        palette.push(color);
+      }
+      raster[y2][x2] = colorMap[hash];
+    }
+  }
+  return PNGEncoder.encode(raster, 8, 3, palette).array;
+};
+
+previous.run = function(photo, bitdepth, dithers) {
+  var pixels = Array.prototype.slice.call(photo);
+  if (bitdepth === 1) {
+    previous.greyscale(pixels, SRC_WIDTH, SRC_HEIGHT);
+  }
+  pixels = previous.resizeSample(pixels, SRC_WIDTH, SRC_HEIGHT, WIDTH, HEIGHT);
+  if (dithers) {
+    previous.dither(pixels, WIDTH, HEIGHT, dithers, bitdepth === 1 ? getChannelGrey : getChannel2);
+  }
+  return pixels;
+};
+
+previous.encode = function(pixels, bitdepth) {
+  return bitdepth === 1 ? previous.toGbitmap1(pixels, WIDTH, HEIGHT) : previous.toPng8(pixels, WIDTH, HEIGHT);
+};
+
+var fused = {};
+
+fused.run = function(photo, bitdepth, dithers) {
+  return image.process(photo, SRC_WIDTH, SRC_HEIGHT, WIDTH, HEIGHT, bitdepth, dithers, true);
+};
+
+fused.encode = function(colors, bitdepth) {
+  return bitdepth === 1 ? image.toGbitmap1(colors, WIDTH, HEIGHT).pixels : image.toPng8(colors, WIDTH, HEIGHT).pixels;
+};
+
+var colorChannel = function(color, channel) {
+  return ((color >> (4 - 2 * channel)) & 0x3) * 85;
+};
+
+//! RMS difference between 3x3 box blurs of GColor8 pixels and of RGBA reference pixels
+var blurError = function(colors, reference, isGrey) {
+  var sum = 0;
+  var count = 0;
+  for (var y = 1; y < HEIGHT - 1; ++y) {
+    for (var x = 1; x < WIDTH - 1; ++x) {
+      for (var c = 0; c < 3; ++c) {
+        var out = 0, ref = 0;
+        for (var dy = -1; dy <= 1; ++dy) {
+          for (var dx = -1; dx <= 1; ++dx) {
+            var index = (y + dy) * WIDTH + x + dx;
+            var pos = index * 4;
+            out += colorChannel(colors[index], c);
+            ref += isGrey ? (reference[pos] + reference[pos + 1] + reference[pos + 2]) / 3 : reference[pos + c];
+          }
+        }
+        var diff = (out - ref) / 9;
+        sum += diff * diff;
+        ++count;
+      }
+    }
+  }
+  return Math.sqrt(sum / count);
+};
+
+var measure = function(fn) {
+  fn();
+  var start = process.hrtime();
+  for (var i = 0; i < ITERATIONS; ++i) {
+    fn();
+  }
+  var elapsed = process.hrtime(start);
+  return (elapsed[0] * 1e3 + elapsed[1] / 1e6) / ITERATIONS;
+};
+
+var pad = function(text, width) {
+  text = String(text);
+  while (text.length < width) {
+    text = ' ' + text;
+  }
+  return text;
+};
+
+var cases = [
+  { name: 'color', bitdepth: 8 },
+  { name: '1-bit', bitdepth: 1 },
+  { name: 'color sierra', bitdepth: 8, dithers: image.dithers.sierra },
+  { name: 'color floyd-steinberg', bitdepth: 8, dithers: image.dithers['floyd-steinberg'] },
+  { name: 'color jarvis-judice-ninke', bitdepth: 8, dithers: image.dithers['jarvis-judice-ninke'] },
+  { name: '1-bit sierra', bitdepth: 1, dithers: image.dithers.sierra },
+  { name: '1-bit floyd-steinberg', bitdepth: 1, dithers: image.dithers['floyd-steinberg'] },
+  { name: 'color bayer-4x4', bitdepth: 8, dithers: image.dithers['bayer-4x4'] },
+  { name: 'color bayer-8x8', bitdepth: 8, dithers: image.dithers['bayer-8x8'] },
+  { name: '1-bit bayer-4x4', bitdepth: 1, dithers: image.dithers['bayer-4x4'] },
+  { name: '1-bit bayer-8x8', bitdepth: 1, dithers: image.dithers['bayer-8x8'] },
+];
+
+var photo = makePhoto();
+
+var failed = false;
+cases.forEach(function(c) {
+  if (c.dithers || c.bitdepth !== 1) { return; }
+  var expected = previous.toColors(previous.run(photo, c.bitdepth), c.bitdepth);
+  var colors = fused.run(photo, c.bitdepth);
+  for (var i = 0; i < expected.length; ++i) {
+    if (expected[i] !== colors[i]) {
+      console.log(c.name + ' differs from the previous pipeline at pixel ' + i);
+      failed = true;
+      return;
+    }
+  }
+});
+if (failed) {
+  process.exit(1);
+}
+console.log('fused pass matches the previous pipeline for undithered 1-bit');
+
+var reference = image.resizeSample(photo, SRC_WIDTH, SRC_HEIGHT, WIDTH, HEIGHT);
+
+console.log(SRC_WIDTH + 'x' + SRC_HEIGHT + ' to ' + WIDTH + 'x' + HEIGHT + ', ' + ITERATIONS + ' iterations');
+console.log(pad('', 26) + pad('previous', 12) + pad('fused', 12) + pad('bytes', 10) +
+            pad('prev err', 10) + pad('err', 8));
+cases.forEach(function(c) {
+  var isGrey = (c.bitdepth === 1);
+  // The previous pipeline only had error diffusion
+  var hasPrevious = !(c.dithers && c.dithers.matrix);
+  var previousMs = '-';
+  var previousErr = '-';
+  if (hasPrevious) {
+    previousMs = measure(function() {
+      previous.encode(previous.run(photo, c.bitdepth, c.dithers), c.bitdepth);
+    }).toFixed(1) + ' ms';
+    var previousColors = previous.toColors(previous.run(photo, c.bitdepth, c.dithers), c.bitdepth);
+    previousErr = blurError(previousColors, reference, isGrey).toFixed(2);
+  }
+  var fusedMs = measure(function() {
+    fused.encode(fused.run(photo, c.bitdepth, c.dithers), c.bitdepth);
+  });
+  var colors = fused.run(photo, c.bitdepth, c.dithers);
+  var bytes = fused.encode(colors, c.bitdepth).length;
+  console.log(pad(c.name, 26) + pad(previousMs, 12) + pad(fusedMs.toFixed(1) + ' ms', 12) +
+              pad(bytes, 10) + pad(previousErr, 10) +
+              pad(blurError(colors, reference, isGrey).toFixed(2), 8));
+});
@@ -4,6 +4,32 @@ var PNGEncoder = require('lib/png-encoder');
 
 var image = {};
 
+//! Image formats, matching SimplyImageFormat on the watch
+image.formats = {
+  raw1Bit: 0,
+  raw1BitPalette: 1,
+  raw2BitPalette: 2,
+  raw4BitPalette: 3,
+  png: 4,
+};
+
+//! Palettized formats from the fewest to the most bits per pixel
+var paletteFormats = [
+  { format: image.formats.raw1BitPalette, bits: 1 },
+  { format: image.formats.raw2BitPalette, bits: 2 },
+  { format: image.formats.raw4BitPalette, bits: 4 }];
+
+var hasFormat = function(formats, format) {
+  return (formats & (1 << format)) !== 0;
+};
+
+//! Whether a set of supported formats can display color
+image.isColor = function(formats) {
+  return paletteFormats.some(function(entry) {
+    return hasFormat(formats, entry.format);
+  });
+};
+
 var getPos = function(width, x, y) {
   return y * width * 4 + x * 4;
 };
@@ -13,14 +39,6 @@ var getPixelGrey = function(pixels, pos) {
   return ((pixels[pos] + pixels[pos + 1] + pixels[pos + 2]) / 3) & 0xFF;
 };
 
-//! Convert an RGB pixel array into a single uint8 2 bitdepth per channel color
-var getPixelColorUint8 = function(pixels, pos) {
-  var r = Math.min(Math.max(parseInt(pixels[pos    ] / 64 + 0.5), 0), 3);
-  var g = Math.min(Math.max(parseInt(pixels[pos + 1] / 64 + 0.5), 0), 3);
-  var b = Math.min(Math.max(parseInt(pixels[pos + 2] / 64 + 0.5), 0), 3);
-  return (0x3 << 6) | (r << 4) | (g << 2) | b;
-};
-
 //! Get an RGB vector from an RGB pixel array
 var getPixelColorRGB8 = function(pixels, pos) {
   return [pixels[pos], pixels[pos + 1], pixels[pos + 2]];
@@ -88,6 +106,28 @@ image.dithers.sierra = [
   [ 0, 2, 3/32],
   [ 1, 2, 2/32]];
 
+//! Build a Bayer threshold matrix with a power of two size
+var makeBayer = function(size) {
+  var matrix = [0];
+  for (var n = 1; n < size; n *= 2) {
+    var next = [];
+    for (var y = 0; y < 2 * n; ++y) {
+      for (var x = 0; x < 2 * n; ++x) {
+        var quadrant = (y >= n ? 2 : 0) + (x >= n ? 1 : 0);
+        next[y * 2 * n + x] = 4 * matrix[(y % n) * n + x % n] + [0, 2, 3, 1][quadrant];
+      }
+    }
+    matrix = next;
+  }
+  return { size: size, matrix: matrix };
+};
+
+//! Ordered dithers offset each value by a threshold from a tiled Bayer matrix instead of diffusing
+//! error. They carry no state between pixels, and their repeating pattern compresses far better in
+//! a PNG than the noise of error diffusion does.
+image.dithers['bayer-4x4'] = makeBayer(4);
+image.dithers['bayer-8x8'] = makeBayer(8);
+
 image.dithers['default'] = image.dithers.sierra;
 
 //! Get the nearest normalized grey color
@@ -100,25 +140,166 @@ var getChannel2 = function(color) {
   return Math.min(Math.max(parseInt(color / 64 + 0.5), 0) * 64, 255);
 };
 
-image.dither = function(pixels, width, height, dithers, converter) {
-  converter = converter || getChannel2;
-  dithers = dithers || image.dithers['default'];
-  var numDithers = dithers.length;
+//! Tabulate a channel converter over the channel range
+var makeLevels = function(converter) {
+  var levels = new Uint8Array(256);
+  for (var i = 0; i < 256; ++i) {
+    levels[i] = converter(i);
+  }
+  return levels;
+};
+
+//! Get the nearest of the four levels that a GColor8 channel displays
+var getChannelDisplay = function(color) {
+  return Math.round(color / 85) * 85;
+};
+
+var greyLevels = makeLevels(getChannelGrey);
+var colorLevels = makeLevels(getChannelDisplay);
+
+//! Fraction bits of the diffused error and of the kernel weights
+var ERROR_SHIFT = 4;
+var WEIGHT_SHIFT = 8;
+
+//! Error diffusion over an image one row at a time. Only the error still to be added is kept, in
+//! one Int16Array per row that the kernel reaches, so two rows for Floyd-Steinberg and three for
+//! the larger kernels. Rows are padded by the kernel's reach to each side so that no tap needs a
+//! bounds check. Serpentine scanning runs odd rows right to left with the kernel mirrored, which
+//! avoids the diagonal drift of scanning every row in the same direction.
+var ErrorDiffusion = function(width, channels, dithers, serpentine) {
+  var reachX = 0;
+  var reachY = 0;
+  dithers.forEach(function(dither) {
+    reachX = Math.max(reachX, Math.abs(dither[0]));
+    reachY = Math.max(reachY, dither[1]);
+  });
+  this.width = width;
+  this.channels = channels;
+  this.serpentine = serpentine;
+  this.pad = reachX * channels;
+  this.taps = dithers.map(function(dither) {
+    return {
+      dx: dither[0] * channels,
+      dy: dither[1],
+      weight: Math.round(dither[2] * (1 << WEIGHT_SHIFT)),
+    };
+  });
+  this.rows = [];
+  for (var i = 0; i <= reachY; ++i) {
+    this.rows[i] = new Int16Array((width + 2 * reachX) * channels);
+  }
+};
+
+//! Dither row y of channel values in place, quantizing each value with a table of levels.
+//! Rows must be given in order starting from 0.
+ErrorDiffusion.prototype.ditherRow = function(values, y, levels) {
+  var channels = this.channels;
+  var rows = this.rows;
+  var numRows = rows.length;
+  var errors = rows[y % numRows];
+  var reverse = this.serpentine && (y & 1);
+
+  var numTaps = this.taps.length;
+  var tapRows = [];
+  var tapOffsets = new Int32Array(numTaps);
+  var tapWeights = new Int32Array(numTaps);
+  for (var t = 0; t < numTaps; ++t) {
+    var tap = this.taps[t];
+    tapRows[t] = rows[(y + tap.dy) % numRows];
+    tapOffsets[t] = reverse ? -tap.dx : tap.dx;
+    tapWeights[t] = tap.weight;
+  }
+
+  var round = 1 << (ERROR_SHIFT - 1);
+  var maxValue = 255 << ERROR_SHIFT;
+  var weightRound = 1 << (WEIGHT_SHIFT - 1);
+  var step = reverse ? -channels : channels;
+  var start = reverse ? (this.width - 1) * channels : 0;
+  for (var x = 0, i = start; x < this.width; ++x, i += step) {
+    for (var k = 0; k < channels; ++k) {
+      var pos = this.pad + i + k;
+      var value = Math.min(Math.max((values[i + k] << ERROR_SHIFT) + errors[pos], 0), maxValue);
+      var newValue = levels[(value + round) >> ERROR_SHIFT];
+      values[i + k] = newValue;
+      var error = value - (newValue << ERROR_SHIFT);
+      for (var j = 0; j < numTaps; ++j) {
+        tapRows[j][pos + tapOffsets[j]] += (error * tapWeights[j] + weightRound) >> WEIGHT_SHIFT;
+      }
+    }
+  }
+
+  // This row is next used for the row numRows below
+  for (var e = 0, ee = errors.length; e < ee; ++e) {
+    errors[e] = 0;
+  }
+};
+
+//! Get the distance between quantization levels, which scales the ordered dither thresholds
+var getLevelStep = function(levels) {
+  for (var i = 0; i < 256; ++i) {
+    if (levels[i]) {
+      return levels[i];
+    }
+  }
+  return 255;
+};
+
+//! Ordered dithering over an image one row at a time with the thresholds scaled to the levels
+var OrderedDither = function(ordered, levels) {
+  var count = ordered.size * ordered.size;
+  var step = getLevelStep(levels);
+  this.mask = ordered.size - 1;
+  this.levels = levels;
+  this.thresholds = new Int16Array(count);
+  for (var i = 0; i < count; ++i) {
+    this.thresholds[i] = Math.round(((ordered.matrix[i] + 0.5) / count - 0.5) * step);
+  }
+};
+
+//! Dither row y of channel values in place
+OrderedDither.prototype.ditherRow = function(values, y, channels) {
+  var levels = this.levels;
+  var thresholds = this.thresholds;
+  var mask = this.mask;
+  var rowPos = (y & mask) * (mask + 1);
+  for (var x = 0, i = 0, ii = values.length; i < ii; ++x) {
+    var threshold = thresholds[rowPos + (x & mask)];
+    for (var k = 0; k < channels; ++k, ++i) {
+      values[i] = levels[Math.min(Math.max(values[i] + threshold, 0), 255)];
+    }
+  }
+};
+
+//! Make the dither for a row of channel values, either ordered or error diffusion
+var makeDither = function(width, channels, dithers, levels, serpentine) {
+  if (dithers.matrix) {
+    var ordered = new OrderedDither(dithers, levels);
+    return function(values, y) {
+      ordered.ditherRow(values, y, channels);
+    };
+  }
+  var diffusion = new ErrorDiffusion(width, channels, dithers, serpentine);
+  return function(values, y) {
+    diffusion.ditherRow(values, y, levels);
+  };
+};
+
+image.dither = function(pixels, width, height, dithers, converter, serpentine) {
+  var levels = makeLevels(converter || getChannel2);
+  var ditherRow = makeDither(width, 3, dithers || image.dithers['default'], levels, serpentine);
+  var values = new Int16Array(width * 3);
   for (var y = 0, yy = height; y < yy; ++y) {
     for (var x = 0, xx = width; x < xx; ++x) {
       var pos = getPos(width, x, y);
       for (var i = 0; i < 3; ++i) {
-        var oldColor = pixels[pos + i];
-        var newColor = converter(oldColor);
-        var error = oldColor - newColor;
-        pixels[pos + i] = newColor;
-        for (var j = 0; j < numDithers; ++j) {
-          var dither = dithers[j];
-          var x2 = x + dither[0], y2 = y + dither[1];
-          if (x2 >= 0 && x2 < width && y < height) {
-            pixels[getPos(width, x2, y2) + i] += parseInt(error * dither[2]);
-          }
-        }
+        values[x * 3 + i] = pixels[pos + i];
+      }
+    }
+    ditherRow(values, y);
+    for (var x2 = 0; x2 < width; ++x2) {
+      var pos2 = getPos(width, x2, y);
+      for (var j = 0; j < 3; ++j) {
+        pixels[pos2 + j] = values[x2 * 3 + j];
       }
     }
   }
@@ -127,19 +308,18 @@ image.dither = function(pixels, width, height, dithers, converter) {
 //! Dither a pixel buffer by image properties
 image.ditherByProps = function(pixels, img, converter) {
   if (img.dither) {
-    var dithers = image.dithers[img.dither];
-    image.dither(pixels, img.width, img.height, dithers, converter);
+    image.dither(pixels, img.width, img.height, image.dithersByProps(img), converter, true);
   }
 };
 
 image.resizeNearest = function(pixels, width, height, newWidth, newHeight) {
-  var newPixels = new Array(newWidth * newHeight * 4);
+  var newPixels = new Uint8ClampedArray(newWidth * newHeight * 4);
   var widthRatio = width / newWidth;
   var heightRatio = height / newHeight;
   for (var y = 0, yy = newHeight; y < yy; ++y) {
     for (var x = 0, xx = newWidth; x < xx; ++x) {
-      var x2 = parseInt(x * widthRatio);
-      var y2 = parseInt(y * heightRatio);
+      var x2 = (x * widthRatio) | 0;
+      var y2 = (y * heightRatio) | 0;
       var pos2 = getPos(width, x2, y2);
       var pos = getPos(newWidth, x, y);
       for (var i = 0; i < 4; ++i) {
@@ -151,19 +331,21 @@ image.resizeNearest = function(pixels, width, height, newWidth, newHeight) {
 };
 
 image.resizeSample = function(pixels, width, height, newWidth, newHeight) {
-  var newPixels = new Array(newWidth * newHeight * 4);
+  var newPixels = new Uint8ClampedArray(newWidth * newHeight * 4);
   var widthRatio = width / newWidth;
   var heightRatio = height / newHeight;
   for (var y = 0, yy = newHeight; y < yy; ++y) {
     for (var x = 0, xx = newWidth; x < xx; ++x) {
-      var x2 = Math.min(parseInt(x * widthRatio), width - 1);
-      var y2 = Math.min(parseInt(y * heightRatio), height - 1);
+      var x2 = Math.min((x * widthRatio) | 0, width - 1);
+      var y2 = Math.min((y * heightRatio) | 0, height - 1);
+      var x3 = Math.min(x2 + 1, width - 1);
+      var y3 = Math.min(y2 + 1, height - 1);
       var pos = getPos(newWidth, x, y);
       for (var i = 0; i < 4; ++i) {
-        newPixels[pos + i] = ((pixels[getPos(width, x2  , y2  ) + i] +
-                               pixels[getPos(width, x2+1, y2  ) + i] +
-                               pixels[getPos(width, x2  , y2+1) + i] +
-                               pixels[getPos(width, x2+1, y2+1) + i]) / 4) & 0xFF;
+        newPixels[pos + i] = (pixels[getPos(width, x2, y2) + i] +
+                              pixels[getPos(width, x3, y2) + i] +
+                              pixels[getPos(width, x2, y3) + i] +
+                              pixels[getPos(width, x3, y3) + i]) >> 2;
       }
     }
   }
@@ -187,32 +369,109 @@ image.resizeByProps = function(pixels, img) {
   }
 };
 
-//! Convert to a GBitmap with bitdepth 1
-image.toGbitmap1 = function(pixels, width, height) {
-  var rowBytes = width * 4;
+//! Get the dither kernel named by image properties, if the image is dithered
+image.dithersByProps = function(img) {
+  if (img.dither) {
+    return image.dithers[img.dither] || image.dithers['default'];
+  }
+};
 
-  var gpixels = [];
-  var growBytes = Math.ceil(width / 32) * 4;
-  for (var i = 0, ii = height * growBytes; i < ii; ++i) {
-    gpixels[i] = 0;
+//! Resize, dither and quantize an RGBA pixel array in a single pass per output row.
+//! Each output row is sampled into one row of channel values which is then dithered in place, so no
+//! full size intermediate buffer is made. Returns a Uint8Array with one GColor8 per output pixel,
+//! which are only black or white when bitdepth is 1.
+image.process = function(pixels, width, height, newWidth, newHeight, bitdepth, dithers, serpentine) {
+  var isGrey = (bitdepth === 1);
+  var channels = isGrey ? 1 : 3;
+  var levels = isGrey ? greyLevels : colorLevels;
+  var isSample = (newWidth < width || newHeight < height);
+  var widthRatio = width / newWidth;
+  var heightRatio = height / newHeight;
+
+  // Source byte offsets of the sampled columns, which are the same for every row
+  var srcX = new Int32Array(newWidth);
+  var srcX2 = new Int32Array(newWidth);
+  for (var col = 0; col < newWidth; ++col) {
+    var srcCol = Math.min((col * widthRatio) | 0, width - 1);
+    srcX[col] = srcCol * 4;
+    srcX2[col] = (isSample ? Math.min(srcCol + 1, width - 1) : srcCol) * 4;
+  }
+
+  var loadRow = function(row, y) {
+    var y2 = Math.min((y * heightRatio) | 0, height - 1);
+    var pos = y2 * width * 4;
+    var pos2 = (isSample ? Math.min(y2 + 1, height - 1) : y2) * width * 4;
+    for (var x = 0, i = 0; x < newWidth; ++x, i += channels) {
+      var a = pos + srcX[x], b = pos + srcX2[x], c = pos2 + srcX[x], d = pos2 + srcX2[x];
+      if (isGrey) {
+        row[i] = isSample ?
+          ((((pixels[a] + pixels[a + 1] + pixels[a + 2]) / 3) | 0) +
+           (((pixels[b] + pixels[b + 1] + pixels[b + 2]) / 3) | 0) +
+           (((pixels[c] + pixels[c + 1] + pixels[c + 2]) / 3) | 0) +
+           (((pixels[d] + pixels[d + 1] + pixels[d + 2]) / 3) | 0)) >> 2 :
+          ((pixels[a] + pixels[a + 1] + pixels[a + 2]) / 3) | 0;
+      } else if (isSample) {
+        row[i    ] = (pixels[a    ] + pixels[b    ] + pixels[c    ] + pixels[d    ]) >> 2;
+        row[i + 1] = (pixels[a + 1] + pixels[b + 1] + pixels[c + 1] + pixels[d + 1]) >> 2;
+        row[i + 2] = (pixels[a + 2] + pixels[b + 2] + pixels[c + 2] + pixels[d + 2]) >> 2;
+      } else {
+        row[i    ] = pixels[a    ];
+        row[i + 1] = pixels[a + 1];
+        row[i + 2] = pixels[a + 2];
+      }
+    }
+  };
+
+  var ditherRow = dithers && makeDither(newWidth, channels, dithers, levels, serpentine);
+  var values = new Int16Array(newWidth * channels);
+  var numValues = values.length;
+  var colors = new Uint8Array(newWidth * newHeight);
+  for (var y = 0; y < newHeight; ++y) {
+    loadRow(values, y);
+    if (ditherRow) {
+      ditherRow(values, y);
+    } else {
+      for (var v = 0; v < numValues; ++v) {
+        values[v] = levels[values[v]];
+      }
+    }
+    var colorPos = y * newWidth;
+    if (isGrey) {
+      for (var x = 0; x < newWidth; ++x) {
+        colors[colorPos + x] = values[x] ? 0xFF : 0xC0;
+      }
+    } else {
+      for (var x2 = 0, i = 0; x2 < newWidth; ++x2, i += 3) {
+        colors[colorPos + x2] = 0xC0 | ((values[i] / 85) << 4) | ((values[i + 1] / 85) << 2) | (values[i + 2] / 85);
+      }
+    }
   }
 
+  return colors;
+};
+
+//! Whether a GColor8 is closer to white than to black
+var isColorLight = function(color) {
+  return ((color >> 4) & 0x3) + ((color >> 2) & 0x3) + (color & 0x3) >= 5;
+};
+
+//! Convert GColor8 pixels to a GBitmap with bitdepth 1
+image.toGbitmap1 = function(colors, width, height) {
+  var growBytes = Math.ceil(width / 32) * 4;
+  var gpixels = new Uint8Array(height * growBytes);
+
   for (var y = 0, yy = height; y < yy; ++y) {
+    var colorPos = y * width;
+    var gbytePos = y * growBytes;
     for (var x = 0, xx = width; x < xx; ++x) {
-      var grey = 0;
-      var pos = getPos(width, x, y);
-      for (var j = 0; j < 3; ++j) {
-        grey += pixels[pos + j];
-      }
-      grey /= 3 * 255;
-      if (grey >= 0.5) {
-        var gbytePos = y * growBytes + parseInt(x / 8);
-        gpixels[gbytePos] += 1 << (x % 8);
+      if (isColorLight(colors[colorPos + x])) {
+        gpixels[gbytePos + (x >> 3)] |= 1 << (x & 7);
       }
     }
   }
 
   var gbitmap = {
+    format: image.formats.raw1Bit,
     width: width,
     height: height,
     pixelsLength: gpixels.length,
@@ -222,31 +481,42 @@ image.toGbitmap1 = function(pixels, width, height) {
   return gbitmap;
 };
 
-//! Convert to a PNG with total color bitdepth 8
-image.toPng8 = function(pixels, width, height) {
-  var raster = image.toRaster(pixels, width, height, getPixelColorRGB8);
-
+//! Map GColor8 pixels to indexes into a palette of the colors in the order they first appear
+var toPaletteIndexes = function(colors) {
+  var indexes = new Uint8Array(colors.length);
+  // Palette index plus one of each color, so that the zero filled map starts with no colors
+  var colorMap = new Uint16Array(256);
   var palette = [];
-  var colorMap = {};
-  var numColors = 0;
-  for (var y = 0, yy = height; y < yy; ++y) {
-    var row = raster[y];
-    for (var x = 0, xx = width; x < xx; ++x) {
-      var color = row[x];
-      var hash = getPixelColorUint8(color, 0);
-      if (!(hash in colorMap)) {
-        colorMap[hash] = numColors;
-        palette[numColors++] = color;
-      }
-     row[x] = colorMap[hash];
+  for (var i = 0, ii = colors.length; i < ii; ++i) {
+    var color = colors[i];
+    if (!colorMap[color]) {
+      palette.push(color);
+      colorMap[color] = palette.length;
     }
+    indexes[i] = colorMap[color] - 1;
+  }
+  return { palette: palette, indexes: indexes };
+};
+
+//! Convert GColor8 pixels to a PNG with total color bitdepth 8
+image.toPng8 = function(colors, width, height) {
+  var mapped = toPaletteIndexes(colors);
+
+  var raster = [];
+  for (var y = 0, yy = height; y < yy; ++y) {
+    raster[y] = mapped.indexes.subarray(y * width, (y + 1) * width);
   }
 
+  var palette = mapped.palette.map(function(color) {
+    return [((color >> 4) & 0x3) * 85, ((color >> 2) & 0x3) * 85, (color & 0x3) * 85];
+  });
+
   var bitdepth = 8;
   var colorType = 3; // 8-bit palette
   var bytes = PNGEncoder.encode(raster, bitdepth, colorType, palette);
 
   var png = {
+    format: image.formats.png,
     width: width,
     height: height,
     pixelsLength: bytes.array.length,
@@ -256,6 +526,69 @@ image.toPng8 = function(pixels, width, height) {
   return png;
 };
 
+//! Convert GColor8 pixels to a palettized GBitmap with the fewest bits per pixel that fits the colors.
+//! Returns undefined if there are more colors than a supported format can hold.
+image.toGbitmapPalette = function(colors, width, height, formats) {
+  var mapped = toPaletteIndexes(colors);
+  var palette = mapped.palette;
+  var indexes = mapped.indexes;
+
+  var entry;
+  for (var i = 0, ii = paletteFormats.length; i < ii && !entry; ++i) {
+    if (palette.length <= (1 << paletteFormats[i].bits) && hasFormat(formats, paletteFormats[i].format)) {
+      entry = paletteFormats[i];
+    }
+  }
+  if (!entry) {
+    return;
+  }
+
+  // The palette is padded to the format's number of colors and followed by byte aligned rows
+  // with the first pixel in the most significant bits
+  var bits = entry.bits;
+  var numColors = 1 << bits;
+  var rowBytes = Math.ceil(width * bits / 8);
+  var gpixels = new Uint8Array(numColors + height * rowBytes);
+  gpixels.set(palette);
+
+  for (var y = 0; y < height; ++y) {
+    var indexPos = y * width;
+    var rowPos = numColors + y * rowBytes;
+    for (var x = 0; x < width; ++x) {
+      var bitPos = x * bits;
+      gpixels[rowPos + (bitPos >> 3)] |= indexes[indexPos + x] << (8 - bits - (bitPos & 7));
+    }
+  }
+
+  var gbitmap = {
+    format: entry.format,
+    width: width,
+    height: height,
+    pixelsLength: gpixels.length,
+    pixels: gpixels,
+  };
+
+  return gbitmap;
+};
+
+//! Compute a 32-bit FNV-1a hash of an encoded image, which is never 0
+image.hash = function(gbitmap) {
+  var hash = 0x811c9dc5;
+  var add = function(byte) {
+    hash ^= byte & 0xFF;
+    hash += (hash << 1) + (hash << 4) + (hash << 7) + (hash << 8) + (hash << 24);
+    hash >>>= 0;
+  };
+  add(gbitmap.width); add(gbitmap.width >> 8);
+  add(gbitmap.height); add(gbitmap.height >> 8);
+  add(gbitmap.format || 0);
+  var pixels = gbitmap.pixels;
+  for (var i = 0, ii = gbitmap.pixelsLength; i < ii; ++i) {
+    add(pixels[i]);
+  }
+  return hash || 1;
+};
+
 //! Set the size maintaining the aspect ratio
 image.setSizeAspect = function(img, width, height) {
   img.originalWidth = width;
@@ -274,26 +607,113 @@ image.setSizeAspect = function(img, width, height) {
   }
 };
 
-image.load = function(img, bitdepth, callback) {
-  PNG.load(img.url, function(png) {
-    var pixels = png.decode();
-    if (bitdepth === 1) {
-      image.greyscale(pixels, png.width, png.height);
+//! Copy GColor8 pixels into a larger buffer at the given position
+image.blit = function(dest, destWidth, colors, width, height, destX, destY) {
+  for (var y = 0; y < height; ++y) {
+    dest.set(colors.subarray(y * width, (y + 1) * width), (destY + y) * destWidth + destX);
+  }
+};
+
+//! Pack images into shelves of a roughly square atlas, setting the x and y of each image
+image.packAtlas = function(imgs) {
+  var area = 0;
+  var width = 0;
+  imgs.forEach(function(img) {
+    area += img.width * img.height;
+    width = Math.max(width, img.width);
+  });
+  width = Math.max(width, Math.ceil(Math.sqrt(area)));
+
+  var sorted = imgs.slice().sort(function(a, b) { return b.height - a.height; });
+  var x = 0, y = 0, shelfHeight = 0;
+  sorted.forEach(function(img) {
+    if (x + img.width > width) {
+      x = 0;
+      y += shelfHeight;
+      shelfHeight = 0;
     }
+    img.x = x;
+    img.y = y;
+    x += img.width;
+    shelfHeight = Math.max(shelfHeight, img.height);
+  });
+
+  return { width: width, height: y + shelfHeight };
+};
+
+//! Encode GColor8 pixels in the smallest of the given supported formats
+image.encode = function(colors, width, height, formats) {
+  if (!image.isColor(formats)) {
+    return image.toGbitmap1(colors, width, height);
+  }
+  var candidates = [];
+  var raw = image.toGbitmapPalette(colors, width, height, formats);
+  if (raw) {
+    candidates.push(raw);
+  }
+  if (hasFormat(formats, image.formats.png)) {
+    candidates.push(image.toPng8(colors, width, height));
+  }
+  if (!candidates.length) {
+    return image.toGbitmap1(colors, width, height);
+  }
+  return candidates.reduce(function(best, candidate) {
+    return candidate.pixelsLength < best.pixelsLength ? candidate : best;
+  });
+};
+
+//! Load, resize, dither and quantize an image to GColor8 pixels without encoding it
+image.loadPixels = function(img, formats, callback) {
+  var bitdepth = image.isColor(formats) ? 8 : 1;
+  PNG.load(img.url, function(png) {
     image.setSizeAspect(img, png.width, png.height);
-    pixels = image.resizeByProps(pixels, img);
-    image.ditherByProps(pixels, img,
-                        bitdepth === 1 ? getChannelGrey : getChannel2);
-    if (bitdepth === 8) {
-      img.image = image.toPng8(pixels, img.width, img.height);
-    } else if (bitdepth === 1) {
-      img.image = image.toGbitmap1(pixels, img.width, img.height);
-    }
+    var colors = image.process(png.decode(), png.width, png.height, img.width, img.height,
+                               bitdepth, image.dithersByProps(img), true);
+    callback(img, colors);
+  });
+  return img;
+};
+
+image.load = function(img, formats, callback) {
+  return image.loadPixels(img, formats, function(img, colors) {
+    img.image = image.encode(colors, img.width, img.height, formats);
     if (callback) {
       callback(img);
     }
   });
-  return img;
+};
+
+//! Load several images and pack them into a single atlas image. An empty list loads nothing.
+image.loadAtlas = function(atlas, imgs, formats, callback) {
+  if (!imgs.length) { return atlas; }
+  var remaining = imgs.length;
+  var colorsList = [];
+  var onLoad = function() {
+    var size = image.packAtlas(imgs);
+    // Space between the sprites is black
+    var colors = new Uint8Array(size.width * size.height);
+    for (var i = 0, ii = colors.length; i < ii; ++i) {
+      colors[i] = 0xC0;
+    }
+    imgs.forEach(function(img, index) {
+      image.blit(colors, size.width, colorsList[index], img.width, img.height, img.x, img.y);
+    });
+    atlas.width = size.width;
+    atlas.height = size.height;
+    atlas.image = image.encode(colors, size.width, size.height, formats);
+    if (callback) {
+      callback(atlas);
+    }
+  };
+  imgs.forEach(function(img, index) {
+    image.loadPixels(img, formats, function(img, colors) {
+      colorsList[index] = colors;
+      if (--remaining === 0) {
+        onLoad();
+      }
+    });
+  });
+  return atlas;
 };
 
 module.exports = image;
@@ -105,7 +105,7 @@ struct.types.data.get = function(offset) {
 };
 
 struct.types.data.set = function(offset, value) {
-  var length = value.byteLength || value.length;
+  var length = value.byteLength !== undefined ? value.byteLength : value.length;
   this._cursor = offset;
   this._grow(offset + length);
   var buffer = this._view;
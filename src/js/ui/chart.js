@@ -0,0 +1,68 @@
+var util2 = require('util2');
+var myutil = require('myutil');
+var Propable = require('ui/propable');
+var WindowStack = require('ui/windowstack');
+var StageElement = require('ui/element');
+var simply = require('ui/simply');
+
+var chartProps = [
+  'mode',
+  'color',
+  'capacity',
+  'min',
+  'max',
+  'autoScale',
+];
+
+var defaults = {
+  backgroundColor: 'clear',
+  borderColor: 'clear',
+  color: 'white',
+  mode: 'line',
+  capacity: 32,
+  min: 0,
+  max: 100,
+  autoScale: true,
+};
+
+var Chart = function(elementDef) {
+  StageElement.call(this, myutil.shadow(defaults, elementDef || {}));
+  this.state.type = StageElement.ChartType;
+  this.state.samples = (this.state.samples || []).slice(-this.state.capacity);
+};
+
+util2.inherit(Chart, StageElement);
+
+Propable.makeAccessors(chartProps, Chart.prototype);
+
+Chart.prototype._prop = function(elementDef) {
+  StageElement.prototype._prop.call(this, elementDef);
+  var changed = chartProps.some(function(k) { return k in elementDef; });
+  if (!changed) { return; }
+  var samples = this.state.samples;
+  if (samples.length > this.state.capacity) {
+    samples.splice(0, samples.length - this.state.capacity);
+  }
+  if (this._window() === WindowStack.top()) {
+    simply.impl.stageChart(this._id(), this.state);
+  }
+};
+
+Chart.prototype.samples = function() {
+  return this.state.samples.slice();
+};
+
+Chart.prototype.append = function(samples) {
+  if (!(samples instanceof Array)) {
+    samples = Array.prototype.slice.call(arguments);
+  }
+  if (!samples.length) { return this; }
+  var state = this.state;
+  state.samples = state.samples.concat(samples).slice(-state.capacity);
+  if (this._window() === WindowStack.top()) {
+    simply.impl.stageChartAppend(this._id(), samples.slice(-state.capacity));
+  }
+  return this;
+};
+
+module.exports = Chart;
@@ -10,6 +10,7 @@ var elementProps = [
   'size',
   'borderColor',
   'backgroundColor',
+  'static',
 ];
 
 var accessorProps = elementProps;
@@ -33,6 +34,9 @@ StageElement.CircleType = 2;
 StageElement.TextType = 3;
 StageElement.ImageType = 4;
 StageElement.InverterType = 5;
+StageElement.GroupType = 6;
+StageElement.PathType = 7;
+StageElement.ChartType = 8;
 
 util2.copy(Propable.prototype, StageElement.prototype);
 
@@ -50,8 +54,16 @@ StageElement.prototype._type = function() {
   return this.state.type;
 };
 
+StageElement.prototype._window = function() {
+  var parent = this.parent;
+  while (parent instanceof StageElement) {
+    parent = parent.parent;
+  }
+  return parent;
+};
+
 StageElement.prototype._prop = function(elementDef) {
-  if (this.parent === WindowStack.top()) {
+  if (this._window() === WindowStack.top()) {
     simply.impl.stageElement(this._id(), this._type(), this.state);
   }
 };
@@ -67,8 +79,31 @@ StageElement.prototype.remove = function(broadcast) {
   return this;
 };
 
+StageElement.prototype._reorder = function(position, sibling) {
+  if (this.parent) {
+    this.parent.move(this, position, sibling);
+  }
+  return this;
+};
+
+StageElement.prototype.moveToFront = function() {
+  return this._reorder('front');
+};
+
+StageElement.prototype.moveToBack = function() {
+  return this._reorder('back');
+};
+
+StageElement.prototype.moveAbove = function(sibling) {
+  return this._reorder('above', sibling);
+};
+
+StageElement.prototype.moveBelow = function(sibling) {
+  return this._reorder('below', sibling);
+};
+
 StageElement.prototype._animate = function(animateDef, duration) {
-  if (this.parent === WindowStack.top()) {
+  if (this._window() === WindowStack.top()) {
     simply.impl.stageAnimate(this._id(), this.state,
         animateDef, duration || 400, animateDef.easing || 'easeInOut');
   }
@@ -101,15 +136,29 @@ StageElement.prototype.dequeue = function() {
   callback.call(this, this.dequeue.bind(this));
 };
 
+var findElement = function(stage, id) {
+  var items = stage._items;
+  for (var i = 0; i < items.length; ++i) {
+    var element = items[i];
+    if (element._id() === id) {
+      return element;
+    }
+    if (element._items) {
+      var child = findElement(element, id);
+      if (child) {
+        return child;
+      }
+    }
+  }
+};
+
 StageElement.emitAnimateDone = function(id) {
   var wind = WindowStack.top();
   if (!wind || !wind._dynamic) { return; }
-  wind.each(function(element) {
-    if (element._id() === id) {
-      element.dequeue();
-      return false;
-    }
-  });
+  var element = findElement(wind, id);
+  if (element) {
+    element.dequeue();
+  }
 };
 
 module.exports = StageElement;
@@ -0,0 +1,75 @@
+var util2 = require('util2');
+var myutil = require('myutil');
+var WindowStack = require('ui/windowstack');
+var StageElement = require('ui/element');
+var Stage = require('ui/stage');
+var simply = require('ui/simply');
+
+var defaults = {
+  backgroundColor: 'clear',
+  borderColor: 'clear',
+};
+
+var Group = function(elementDef) {
+  StageElement.call(this, myutil.shadow(defaults, elementDef || {}));
+  this.state.type = StageElement.GroupType;
+  this._items = [];
+};
+
+util2.inherit(Group, StageElement);
+
+Group.prototype.each = Stage.prototype.each;
+Group.prototype.at = Stage.prototype.at;
+Group.prototype.insert = Stage.prototype.insert;
+Group.prototype.add = Stage.prototype.add;
+Group.prototype.move = Stage.prototype.move;
+
+Group.prototype._reset = function() {
+  StageElement.prototype._reset.call(this);
+  this._loaded = false;
+};
+
+Group.prototype._load = function() {
+  if (this._loaded) { return; }
+  this._loaded = true;
+  Stage.prototype._show.call(this);
+};
+
+Group.prototype._insert = function(index, element) {
+  if (this._loaded && this._window() === WindowStack.top()) {
+    simply.impl.stageElement(element._id(), element._type(), element.state, index, this._id());
+    if (element._load) {
+      element._load();
+    }
+  }
+};
+
+Group.prototype._remove = function(element, broadcast) {
+  if (broadcast === false) { return; }
+  if (this._loaded && this._window() === WindowStack.top()) {
+    simply.impl.stageRemove(element._id());
+  }
+  element._reset();
+};
+
+Group.prototype._move = function(element, position, sibling) {
+  if (this._loaded && this._window() === WindowStack.top()) {
+    simply.impl.stageMove(element._id(), position, sibling && sibling._id());
+  }
+};
+
+Group.prototype.index = function(element) {
+  if (element === undefined) {
+    return StageElement.prototype.index.call(this);
+  }
+  return Stage.prototype.index.call(this, element);
+};
+
+Group.prototype.remove = function(element, broadcast) {
+  if (element instanceof StageElement) {
+    return Stage.prototype.remove.call(this, element, broadcast);
+  }
+  return StageElement.prototype.remove.call(this, element);
+};
+
+module.exports = Group;
@@ -1,3 +1,4 @@
+var util2 = require('util2');
 var imagelib = require('lib/image');
 var myutil = require('myutil');
 var Platform = require('platform');
@@ -6,16 +7,76 @@ var simply = require('ui/simply');
 
 var ImageService = module.exports;
 
+/**
+ * Largest encoded image that the watch keeps in its persistent image store.
+ * This must match IMAGE_STORE_MAX_SIZE in simply_image_store.h.
+ */
+var maxStoredSize = 2048;
+
+var contentHashesKey = 'imageContentHashes';
+
+/**
+ * Most content hashes remembered across launches. The least recently loaded are forgotten first.
+ */
+var maxContentHashes = 64;
+
 var state;
 
+var loadContentHashes = function() {
+  try {
+    return JSON.parse(localStorage.getItem(contentHashesKey)) || {};
+  } catch (e) {
+    return {};
+  }
+};
+
+var saveContentHashes = function() {
+  localStorage.setItem(contentHashesKey, JSON.stringify(state.contentHashes));
+};
+
+/**
+ * Remember or forget the content hash of an image. Keys keep their insertion order, so the entry is
+ * moved to the end and the oldest entries are dropped past the limit.
+ */
+var setContentHash = function(hash, contentHash) {
+  var contentHashes = state.contentHashes;
+  delete contentHashes[hash];
+  if (contentHash) {
+    contentHashes[hash] = contentHash;
+  }
+  var keys = Object.keys(contentHashes);
+  for (var i = 0, ii = keys.length - maxContentHashes; i < ii; ++i) {
+    delete contentHashes[keys[i]];
+  }
+  saveContentHashes();
+};
+
 ImageService.init = function() {
   state = ImageService.state = {
     cache: {},
+    // Cached images and atlases by the id they have on the watch
+    ids: {},
     nextId: Resource.items.length + 1,
     rootUrl: undefined,
+    // Content hashes of stored images by image hash, kept across launches
+    contentHashes: loadContentHashes(),
+    // Content hashes the watch reported holding, unknown until it reports
+    storedHashes: undefined,
+    // Image formats the watch reported supporting as a bit mask of imagelib.formats
+    formats: undefined,
   };
 };
 
+/**
+ * The formats the watch supports. Until it reports them, assume what the platform has always taken.
+ */
+var getFormats = function() {
+  if (state.formats !== undefined) {
+    return state.formats;
+  }
+  return Platform.version() === 'basalt' ? (1 << imagelib.formats.png) : (1 << imagelib.formats.raw1Bit);
+};
+
 var makeImageHash = function(image) {
   var url = image.url;
   var hashPart = '';
@@ -66,6 +127,13 @@ ImageService.load = function(opt, reset, callback) {
   var hash = makeImageHash(opt);
   var image = state.cache[hash];
   var fetch = false;
+  if (image && image.atlas) {
+    var atlas = state.cache[image.atlas];
+    if (!image.loaded && atlas.image) {
+      sendAtlas(atlas);
+    }
+    return image.id;
+  }
   if (image) {
     if ((opt.width && image.width !== opt.width) ||
         (opt.height && image.height !== opt.height) ||
@@ -82,14 +150,16 @@ ImageService.load = function(opt, reset, callback) {
       id: state.nextId++,
       url: url,
     };
+    state.ids[image.id] = image;
   }
   image.width = opt.width;
   image.height = opt.height;
   image.dither =  opt.dither;
   image.loaded = true;
+  image.hash = hash;
   state.cache[hash] = image;
   var onLoad = function() {
-    simply.impl.image(image.id, image.image);
+    sendImage(image);
     if (callback) {
       var e = {
         type: 'image',
@@ -99,15 +169,154 @@ ImageService.load = function(opt, reset, callback) {
       callback(e);
     }
   };
-  if (fetch) {
-    var bitdepth = Platform.version() === 'basalt' ? 8 : 1;
-    imagelib.load(image, bitdepth, onLoad);
+  var contentHash = state.contentHashes[hash];
+  if (fetch && contentHash && (!state.storedHashes || state.storedHashes[contentHash])) {
+    // The watch has this image stored from an earlier launch, it only needs to bind it to the id.
+    // If it no longer has it, it will report a miss and the image is fetched then. The image is
+    // still fetched afterwards in case it changed, and is only sent if it did.
+    image.contentHash = contentHash;
+    onLoad();
+    fetchImage(image, function() {
+      if (state.cache[image.hash] === image && image.image.hash !== contentHash) {
+        sendImage(image);
+      }
+    });
+  } else if (fetch) {
+    fetchImage(image, onLoad);
   } else {
     onLoad();
   }
   return image.id;
 };
 
+var fetchImage = function(image, callback) {
+  imagelib.load(image, getFormats(), function() {
+    var gbitmap = image.image;
+    if (gbitmap.pixelsLength <= maxStoredSize) {
+      gbitmap.hash = image.contentHash = imagelib.hash(gbitmap);
+    } else {
+      delete image.contentHash;
+    }
+    setContentHash(image.hash, image.contentHash);
+    callback(image);
+  });
+};
+
+var sendImage = function(image) {
+  if (image.image) {
+    simply.impl.image(image.id, image.image);
+  } else {
+    simply.impl.imageBind(image.id, image.contentHash);
+  }
+};
+
+/**
+ * Called with the image formats the watch can create bitmaps from, as a bit mask of imagelib.formats.
+ * Images are encoded in whichever of these is smallest.
+ */
+ImageService.setFormats = function(formats) {
+  state.formats = formats;
+};
+
+/**
+ * Called with the content hashes that the watch holds in its persistent image store.
+ */
+ImageService.setStoredHashes = function(hashes) {
+  state.storedHashes = {};
+  hashes.forEach(function(hash) {
+    state.storedHashes[hash] = true;
+  });
+};
+
+/**
+ * Called when the watch could not bind an image from its store, which is then transferred.
+ */
+ImageService.onMiss = function(id, contentHash) {
+  if (state.storedHashes) {
+    delete state.storedHashes[contentHash];
+  }
+  var image = state.ids[id];
+  if (image && !image.sprites) {
+    fetchImage(image, sendImage);
+  }
+};
+
+/**
+ * Called when the watch evicted an image from its cache. The image is uploaded again the next time
+ * it is used. Evicting an atlas also evicts all of its sprites.
+ */
+ImageService.markUnloaded = function(id) {
+  var image = state.ids[id];
+  if (!image) { return; }
+  delete image.loaded;
+  if (image.sprites) {
+    image.sprites.forEach(function(sprite) {
+      delete sprite.loaded;
+    });
+  }
+};
+
+var sendAtlas = function(atlas) {
+  simply.impl.image(atlas.id, atlas.image);
+  atlas.loaded = true;
+  atlas.sprites.forEach(function(sprite) {
+    simply.impl.imageSprite(sprite.id, atlas.id, sprite);
+    sprite.loaded = true;
+  });
+};
+
+/**
+ * Load several small images as sprites of a single atlas image. Each image keeps its own id, so it
+ * can be used anywhere an image can, but only the atlas is decoded and cached on the watch.
+ * Nothing is loaded for an empty list, and no id is returned.
+ */
+ImageService.loadAtlas = function(opts, callback) {
+  if (!opts || !opts.length) { return; }
+  var sprites = opts.map(function(opt) {
+    return typeof opt === 'string' ? parseImageHash(opt) : util2.copy(opt);
+  });
+  var hashes = sprites.map(makeImageHash);
+  var atlasHash = 'atlas:' + hashes.join('|');
+  var atlas = state.cache[atlasHash];
+  if (atlas) {
+    if (!atlas.loaded && atlas.image) {
+      sendAtlas(atlas);
+    }
+    return atlas.id;
+  }
+  atlas = state.cache[atlasHash] = {
+    id: state.nextId++,
+    url: atlasHash,
+    sprites: sprites,
+  };
+  state.ids[atlas.id] = atlas;
+  sprites.forEach(function(sprite, index) {
+    sprite.id = state.nextId++;
+    sprite.url = myutil.abspath(state.rootUrl, sprite.url);
+    sprite.atlas = atlasHash;
+    state.cache[hashes[index]] = sprite;
+  });
+  imagelib.loadAtlas(atlas, sprites, getFormats(), function() {
+    sendAtlas(atlas);
+    if (callback) {
+      callback({
+        type: 'atlas',
+        image: atlas.id,
+        images: sprites.map(function(sprite) { return sprite.id; }),
+      });
+    }
+  });
+  return atlas.id;
+};
+
+/**
+ * Set the number of bytes the watch may spend on cached images. Images that are not displayed are
+ * evicted, least recently drawn first, to stay within the budget. Passing 0 restores the default.
+ */
+ImageService.setBudget = function(budget) {
+  simply.impl.imageBudget(budget);
+};
+
 ImageService.setRootUrl = function(url) {
   state.rootUrl = url;
 };
@@ -121,10 +330,4 @@ ImageService.resolve = function(opt) {
   return typeof id !== 'undefined' ? id : ImageService.load(opt);
 };
 
-ImageService.markAllUnloaded = function() {
-  for (var k in state.cache) {
-    delete state.cache[k].loaded;
-  }
-};
-
 ImageService.init();
@@ -10,6 +10,9 @@ UI.Text = require('ui/text');
 UI.TimeText = require('ui/timetext');
 UI.Image = require('ui/image');
 UI.Inverter = require('ui/inverter');
+UI.Group = require('ui/group');
+UI.Path = require('ui/path');
+UI.Chart = require('ui/chart');
 UI.Vibe = require('ui/vibe');
 UI.Light = require('ui/light');
 
@@ -150,10 +150,26 @@ Menu.prototype._resolveMenu = function(clear, pushing) {
   var sections = this._getSections(this);
   if (this === WindowStack.top()) {
     simply.impl.menu(this.state, clear, pushing);
+    this._resolveSections();
     return true;
   }
 };
 
+//! Sends the leading sections whose title and item count are already known, without calling any
+//! providers. The remaining sections are requested by the watch as they are shown.
+Menu.prototype._resolveSections = function() {
+  var sections = this._getSections();
+  var known = [];
+  for (var i = 0, ii = sections.length; i < ii; ++i) {
+    var section = sections[i];
+    if (!section || !(section.items instanceof Array || typeof section.items === 'number')) { break; }
+    known.push(section);
+  }
+  if (known.length) {
+    simply.impl.menuSections(known);
+  }
+};
+
 Menu.prototype._resolveSection = function(e, clear) {
   var section = this._getSection(e);
   if (!section) { return; }
@@ -177,13 +193,27 @@ Menu.prototype._resolveItem = function(e) {
   }
 };
 
+Menu.prototype._resolveItems = function(sectionIndex, itemIndices) {
+  var records = [];
+  for (var i = 0, ii = itemIndices.length; i < ii; ++i) {
+    var item = this._getItem({ sectionIndex: sectionIndex, itemIndex: itemIndices[i] });
+    if (item) {
+      records.push({ index: itemIndices[i], item: item });
+    }
+  }
+  if (records.length && this === WindowStack.top()) {
+    simply.impl.menuItems.call(this, sectionIndex, records);
+    return true;
+  }
+};
+
 Menu.prototype._preloadItems = function(e) {
-  var select = util2.copy(e);
-  select.itemIndex = Math.max(0, select.itemIndex - Math.floor(this._numPreloadItems / 2));
+  var first = Math.max(0, e.itemIndex - Math.floor(this._numPreloadItems / 2));
+  var itemIndices = [];
   for (var i = 0; i < this._numPreloadItems; ++i) {
-    this._resolveItem(select);
-    select.itemIndex++;
+    itemIndices.push(first + i);
   }
+  this._resolveItems(e.sectionIndex, itemIndices);
 };
 
 Menu.prototype._emitSelect = function(e) {
@@ -351,6 +381,25 @@ Menu.emitItem = function(sectionIndex, itemIndex) {
   menu._resolveItem(e);
 };
 
+Menu.emitItemRange = function(sectionIndex, itemIndex, numItems) {
+  var menu = WindowStack.top();
+  if (!(menu instanceof Menu)) { return; }
+  var itemIndices = [];
+  for (var i = 0; i < numItems; ++i) {
+    var e = {
+      menu: menu,
+      sectionIndex: sectionIndex,
+      itemIndex: itemIndex + i,
+    };
+    e.section = menu._getSection(e);
+    e.item = menu._getItem(e);
+    if (Menu.emit('item', null, e) !== false) {
+      itemIndices.push(e.itemIndex);
+    }
+  }
+  menu._resolveItems(sectionIndex, itemIndices);
+};
+
 Menu.emitSelect = function(type, sectionIndex, itemIndex) {
   var menu = WindowStack.top();
   if (!(menu instanceof Menu)) { return; }
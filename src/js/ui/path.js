@@ -0,0 +1,51 @@
+var util2 = require('util2');
+var myutil = require('myutil');
+var Propable = require('ui/propable');
+var WindowStack = require('ui/windowstack');
+var StageElement = require('ui/element');
+var simply = require('ui/simply');
+
+var pathProps = [
+  'points',
+  'closed',
+  'strokeWidth',
+];
+
+var defaults = {
+  backgroundColor: 'clear',
+  borderColor: 'white',
+  closed: false,
+  strokeWidth: 1,
+};
+
+var Path = function(elementDef) {
+  StageElement.call(this, myutil.shadow(defaults, elementDef || {}));
+  this.state.type = StageElement.PathType;
+  this.state.points = (this.state.points || []).slice();
+};
+
+util2.inherit(Path, StageElement);
+
+Propable.makeAccessors(pathProps, Path.prototype);
+
+Path.prototype._prop = function(elementDef) {
+  StageElement.prototype._prop.call(this, elementDef);
+  if (this._window() !== WindowStack.top()) { return; }
+  if ('points' in elementDef || 'closed' in elementDef || 'strokeWidth' in elementDef) {
+    simply.impl.stagePath(this._id(), this.state);
+  }
+};
+
+Path.prototype.append = function(points) {
+  if (!(points instanceof Array)) {
+    points = Array.prototype.slice.call(arguments);
+  }
+  if (!points.length) { return this; }
+  this.state.points = this.state.points.concat(points);
+  if (this._window() === WindowStack.top()) {
+    simply.impl.stagePathAppend(this._id(), points);
+  }
+  return this;
+};
+
+module.exports = Path;
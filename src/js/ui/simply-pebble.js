@@ -72,6 +72,66 @@ var SizeType = function(x) {
   this.sizeH(x.y);
 };
 
+var PointsType = function(points) {
+  var view = new DataView(new ArrayBuffer(points.length * 4));
+  for (var i = 0, ii = points.length; i < ii; ++i) {
+    view.setInt16(i * 4, points[i].x, true);
+    view.setInt16(i * 4 + 2, points[i].y, true);
+  }
+  return view;
+};
+
+var SamplesType = function(samples) {
+  var view = new DataView(new ArrayBuffer(samples.length * 2));
+  for (var i = 0, ii = samples.length; i < ii; ++i) {
+    view.setInt16(i * 2, samples[i], true);
+  }
+  return view;
+};
+
+var UTF8String = function(x) {
+  return x ? unescape(encodeURIComponent(StringType(x))) : '';
+};
+
+var pushUint = function(bytes, value, size) {
+  for (var i = 0; i < size; ++i) {
+    bytes.push((value >> (i * 8)) & 0xFF);
+  }
+};
+
+var pushString = function(bytes, value) {
+  for (var i = 0, ii = value.length; i < ii; ++i) {
+    bytes.push(value.charCodeAt(i));
+  }
+  bytes.push(0);
+};
+
+var MenuSectionsType = function(sections) {
+  var bytes = [];
+  sections.forEach(function(section) {
+    var title = UTF8String(section.title);
+    pushUint(bytes, EnumerableType(section.items), 2);
+    pushUint(bytes, title.length, 2);
+    pushString(bytes, title);
+  });
+  return bytes;
+};
+
+var MenuItemsType = function(records) {
+  var bytes = [];
+  records.forEach(function(record) {
+    var title = UTF8String(record.item.title);
+    var subtitle = UTF8String(record.item.subtitle);
+    pushUint(bytes, record.index, 2);
+    pushUint(bytes, ImageType(record.item.icon), 4);
+    pushUint(bytes, title.length, 2);
+    pushUint(bytes, subtitle.length, 2);
+    pushString(bytes, title);
+    pushString(bytes, subtitle);
+  });
+  return bytes;
+};
+
 var hexColorMap = {
   '#000000': 0xC0,
   '#000055': 0xC1,
@@ -431,6 +491,22 @@ var LightTypes = [
 
 var LightType = makeArrayType(LightTypes);
 
+var ChartModeTypes = [
+  'line',
+  'bar',
+];
+
+var ChartModeType = makeArrayType(ChartModeTypes);
+
+var MovePositionTypes = [
+  'front',
+  'back',
+  'above',
+  'below',
+];
+
+var MovePositionType = makeArrayType(MovePositionTypes);
+
 var DictationSessionStatus = [
   null,
   'transcriptionRejected',
@@ -549,12 +625,60 @@ var LongClickPacket = new struct([
 var ImagePacket = new struct([
   [Packet, 'packet'],
   ['uint32', 'id'],
+  ['uint32', 'hash'],
+  ['uint8', 'format'],
   ['int16', 'width'],
   ['int16', 'height'],
   ['uint16', 'pixelsLength'],
   ['data', 'pixels'],
 ]);
 
+var ImageSpritePacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['uint32', 'atlas'],
+  ['int16', 'x'],
+  ['int16', 'y'],
+  ['int16', 'width'],
+  ['int16', 'height'],
+]);
+
+var ImageBudgetPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'budget'],
+]);
+
+var ImageBindPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['uint32', 'hash'],
+]);
+
+var ImageMissPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['uint32', 'hash'],
+]);
+
+var ImageHash = new struct([
+  ['uint32', 'hash'],
+]);
+
+var ImageStoreHashesPacket = new struct([
+  [Packet, 'packet'],
+  ['uint8', 'numHashes'],
+]);
+
+var ImageEvictedPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+]);
+
+var ImageFormatsPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'formats'],
+]);
+
 var CardClearPacket = new struct([
   [Packet, 'packet'],
   ['uint8', 'flags'],
@@ -578,6 +702,24 @@ var CardStylePacket = new struct([
   ['uint8', 'style', CardStyleType],
 ]);
 
+var CardDefinePacket = new struct([
+  [Packet, 'packet'],
+  ['uint8', 'clearFlags'],
+  ['uint8', 'textMask'],
+  ['uint8', 'imageMask'],
+  ['bool', 'hasStyle', BoolType],
+  ['uint8', 'style', CardStyleType],
+  ['uint8', 'titleColor', Color],
+  ['uint8', 'subtitleColor', Color],
+  ['uint8', 'bodyColor', Color],
+  ['uint32', 'icon', ImageType],
+  ['uint32', 'subicon', ImageType],
+  ['uint32', 'banner', ImageType],
+  ['cstring', 'title', StringType],
+  ['cstring', 'subtitle', StringType],
+  ['cstring', 'body', StringType],
+]);
+
 var VibePacket = new struct([
   [Packet, 'packet'],
   ['uint8', 'type', VibeType],
@@ -645,6 +787,12 @@ var MenuSectionPacket = new struct([
   ['cstring', 'title', StringType],
 ]);
 
+var MenuSectionsPacket = new struct([
+  [Packet, 'packet'],
+  ['uint16', 'numSections'],
+  ['data', 'records', MenuSectionsType],
+]);
+
 var MenuGetSectionPacket = new struct([
   [Packet, 'packet'],
   ['uint16', 'section'],
@@ -667,6 +815,20 @@ var MenuGetItemPacket = new struct([
   ['uint16', 'item'],
 ]);
 
+var MenuGetItemRangePacket = new struct([
+  [Packet, 'packet'],
+  ['uint16', 'section'],
+  ['uint16', 'item'],
+  ['uint16', 'numItems'],
+]);
+
+var MenuItemsPacket = new struct([
+  [Packet, 'packet'],
+  ['uint16', 'section'],
+  ['uint16', 'numItems'],
+  ['data', 'records', MenuItemsType],
+]);
+
 var MenuSelectionPacket = new struct([
   [Packet, 'packet'],
   ['uint16', 'section'],
@@ -706,6 +868,7 @@ var ElementInsertPacket = new struct([
   ['uint32', 'id'],
   ['uint8', 'type'],
   ['uint16', 'index'],
+  ['uint32', 'parent'],
 ]);
 
 var ElementRemovePacket = new struct([
@@ -713,6 +876,13 @@ var ElementRemovePacket = new struct([
   ['uint32', 'id'],
 ]);
 
+var ElementMovePacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['uint8', 'position', MovePositionType],
+  ['uint32', 'sibling'],
+]);
+
 var GPoint = new struct([
   ['int16', 'x'],
   ['int16', 'y'],
@@ -767,6 +937,29 @@ var ElementImagePacket = new struct([
   ['uint8', 'compositing', CompositingOp],
 ]);
 
+var ElementDefinePacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['uint8', 'type'],
+  ['uint8', 'flags'],
+  ['uint16', 'index'],
+  ['uint32', 'parent'],
+  [GPoint, 'position', PositionType],
+  [GSize, 'size', SizeType],
+  ['uint8', 'backgroundColor', Color],
+  ['uint8', 'borderColor', Color],
+  ['uint16', 'radius', EnumerableType],
+  ['uint32', 'image', ImageType],
+  ['uint8', 'compositing', CompositingOp],
+  ['uint8', 'color', Color],
+  ['uint8', 'textOverflow', TextOverflowMode],
+  ['uint8', 'textAlign', TextAlignment],
+  ['uint8', 'updateTimeUnits', TimeUnits],
+  ['uint32', 'customFont'],
+  ['cstring', 'systemFont', StringType],
+  ['cstring', 'text', StringType],
+]);
+
 var ElementAnimatePacket = new struct([
   [Packet, 'packet'],
   ['uint32', 'id'],
@@ -796,6 +989,48 @@ var VoiceDictationDataPacket = new struct([
   ['cstring', 'transcription'],
 ]);
 
+var BatchBeginPacket = new struct([
+  [Packet, 'packet'],
+]);
+
+var BatchCommitPacket = new struct([
+  [Packet, 'packet'],
+]);
+
+var ElementPathPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['bool', 'closed', BoolType],
+  ['uint8', 'strokeWidth'],
+  ['uint16', 'numPoints'],
+  ['data', 'points', PointsType],
+]);
+
+var ElementPathAppendPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['uint16', 'numPoints'],
+  ['data', 'points', PointsType],
+]);
+
+var ElementChartPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['uint8', 'mode', ChartModeType],
+  ['bool', 'autoScale', BoolType],
+  ['uint8', 'color', Color],
+  ['uint16', 'capacity'],
+  ['int16', 'min'],
+  ['int16', 'max'],
+]);
+
+var ElementChartAppendPacket = new struct([
+  [Packet, 'packet'],
+  ['uint32', 'id'],
+  ['uint16', 'numSamples'],
+  ['data', 'samples', SamplesType],
+]);
+
 var CommandPackets = [
   Packet,
   SegmentPacket,
@@ -850,6 +1085,25 @@ var CommandPackets = [
   VoiceDictationStartPacket,
   VoiceDictationStopPacket,
   VoiceDictationDataPacket,
+  ElementDefinePacket,
+  CardDefinePacket,
+  BatchBeginPacket,
+  BatchCommitPacket,
+  ElementPathPacket,
+  ElementPathAppendPacket,
+  ElementChartPacket,
+  ElementChartAppendPacket,
+  ImageSpritePacket,
+  ElementMovePacket,
+  MenuGetItemRangePacket,
+  MenuItemsPacket,
+  MenuSectionsPacket,
+  ImageBudgetPacket,
+  ImageBindPacket,
+  ImageMissPacket,
+  ImageStoreHashesPacket,
+  ImageEvictedPacket,
+  ImageFormatsPacket,
 ];
 
 var accelAxes = [
@@ -858,6 +1112,15 @@ var accelAxes = [
   'z',
 ];
 
+var elementDefineFlagMap = {
+  insert: (1 << 0),
+  radius: (1 << 1),
+  textStyle: (1 << 2),
+  text: (1 << 3),
+  image: (1 << 4),
+  static: (1 << 5),
+};
+
 var clearFlagMap = {
   action: (1 << 0),
   text: (1 << 1),
@@ -1016,6 +1279,14 @@ SimplyPebble.ready = function() {
   SimplyPebble.sendPacket(ReadyPacket);
 };
 
+SimplyPebble.batchBegin = function() {
+  SimplyPebble.sendPacket(BatchBeginPacket);
+};
+
+SimplyPebble.batchCommit = function() {
+  SimplyPebble.sendPacket(BatchCommitPacket);
+};
+
 SimplyPebble.wakeupSet = function(timestamp, cookie, notifyIfMissed) {
   WakeupSetPacket
     .timestamp(timestamp)
@@ -1066,7 +1337,26 @@ SimplyPebble.windowActionBar = function(def) {
 };
 
 SimplyPebble.image = function(id, gbitmap) {
-  SimplyPebble.sendPacket(ImagePacket.id(id).prop(gbitmap));
+  SimplyPebble.sendPacket(ImagePacket.id(id).hash(gbitmap.hash || 0).format(gbitmap.format || 0).prop(gbitmap));
+};
+
+SimplyPebble.imageBind = function(id, hash) {
+  SimplyPebble.sendPacket(ImageBindPacket.id(id).hash(hash));
+};
+
+SimplyPebble.imageSprite = function(id, atlas, rect) {
+  ImageSpritePacket
+    .id(id)
+    .atlas(atlas)
+    .x(rect.x)
+    .y(rect.y)
+    .width(rect.width)
+    .height(rect.height);
+  SimplyPebble.sendPacket(ImageSpritePacket);
+};
+
+SimplyPebble.imageBudget = function(budget) {
+  SimplyPebble.sendPacket(ImageBudgetPacket.budget(budget || 0));
 };
 
 var toClearFlags = function(clear) {
@@ -1110,22 +1400,37 @@ SimplyPebble.card = function(def, clear, pushing) {
   if (arguments.length === 3) {
     SimplyPebble.windowShow({ type: 'card', pushing: pushing });
   }
-  if (clear !== undefined) {
-    SimplyPebble.cardClear(clear);
-  }
   SimplyPebble.windowProps(def);
-  if (def.action !== undefined) {
-    SimplyPebble.windowActionBar(def.action);
+  var textMask = 0;
+  var imageMask = 0;
+  var i;
+  for (i = 0; i < CardTextTypes.length; ++i) {
+    var textType = CardTextTypes[i];
+    var hasText = def[textType] !== undefined;
+    if (hasText) {
+      textMask |= 1 << i;
+    }
+    CardDefinePacket[CardTextColorTypes[i]](hasText && def[CardTextColorTypes[i]] || 'clearWhite');
   }
-  for (var k in def) {
-    var textIndex = CardTextTypes.indexOf(k);
-    if (textIndex !== -1) {
-      SimplyPebble.cardText(k, def[k], def[CardTextColorTypes[textIndex]]);
-    } else if (CardImageTypes.indexOf(k) !== -1) {
-      SimplyPebble.cardImage(k, def[k]);
-    } else if (k === 'style') {
-      SimplyPebble.cardStyle(k, def[k]);
+  for (i = 0; i < CardImageTypes.length; ++i) {
+    var imageType = CardImageTypes[i];
+    if (def[imageType] !== undefined) {
+      imageMask |= 1 << i;
     }
+    CardDefinePacket[imageType](def[imageType]);
+  }
+  CardDefinePacket
+    .clearFlags(toClearFlags(clear) || 0)
+    .textMask(textMask)
+    .imageMask(imageMask)
+    .hasStyle(def.style !== undefined)
+    .style(def.style)
+    .title(def.title || '')
+    .subtitle(def.subtitle || '')
+    .body(def.body || '');
+  SimplyPebble.sendPacket(CardDefinePacket);
+  if (def.action !== undefined) {
+    SimplyPebble.windowActionBar(def.action);
   }
 };
 
@@ -1218,6 +1523,13 @@ SimplyPebble.menuSection = function(section, def, clear) {
   SimplyPebble.sendPacket(MenuSectionPacket);
 };
 
+SimplyPebble.menuSections = function(sections) {
+  MenuSectionsPacket
+    .numSections(sections.length)
+    .records(sections);
+  SimplyPebble.sendPacket(MenuSectionsPacket);
+};
+
 SimplyPebble.menuItem = function(section, item, def) {
   MenuItemPacket
     .section(section)
@@ -1230,6 +1542,14 @@ SimplyPebble.menuItem = function(section, item, def) {
   SimplyPebble.sendPacket(MenuItemPacket);
 };
 
+SimplyPebble.menuItems = function(section, records) {
+  MenuItemsPacket
+    .section(section)
+    .numItems(records.length)
+    .records(records);
+  SimplyPebble.sendPacket(MenuItemsPacket);
+};
+
 SimplyPebble.menuSelection = function(section, item, align) {
   if (section === undefined) {
     SimplyPebble.sendPacket(MenuGetSelectionPacket);
@@ -1249,14 +1569,18 @@ SimplyPebble.menu = function(def, clear, pushing) {
   SimplyPebble.menuProps(def);
 };
 
-SimplyPebble.elementInsert = function(id, type, index) {
-  SimplyPebble.sendPacket(ElementInsertPacket.id(id).type(type).index(index));
+SimplyPebble.elementInsert = function(id, type, index, parent) {
+  SimplyPebble.sendPacket(ElementInsertPacket.id(id).type(type).index(index).parent(parent || 0));
 };
 
 SimplyPebble.elementRemove = function(id) {
   SimplyPebble.sendPacket(ElementRemovePacket.id(id));
 };
 
+SimplyPebble.elementMove = function(id, position, sibling) {
+  SimplyPebble.sendPacket(ElementMovePacket.id(id).position(position).sibling(sibling || 0));
+};
+
 SimplyPebble.elementCommon = function(id, def) {
   ElementCommonPacket
     .id(id)
@@ -1289,6 +1613,41 @@ SimplyPebble.elementImage = function(id, image, compositing) {
   SimplyPebble.sendPacket(ElementImagePacket.id(id).image(image).compositing(compositing));
 };
 
+SimplyPebble.elementPath = function(id, def) {
+  var points = def.points || [];
+  ElementPathPacket
+    .id(id)
+    .closed(def.closed)
+    .strokeWidth(def.strokeWidth || 1)
+    .numPoints(points.length)
+    .points(points);
+  SimplyPebble.sendPacket(ElementPathPacket);
+};
+
+SimplyPebble.elementPathAppend = function(id, points) {
+  SimplyPebble.sendPacket(ElementPathAppendPacket.id(id).numPoints(points.length).points(points));
+};
+
+SimplyPebble.elementChart = function(id, def) {
+  ElementChartPacket
+    .id(id)
+    .mode(def.mode)
+    .autoScale(def.autoScale)
+    .color(def.color)
+    .capacity(def.capacity)
+    .min(def.min)
+    .max(def.max);
+  SimplyPebble.sendPacket(ElementChartPacket);
+  if (def.samples && def.samples.length) {
+    SimplyPebble.elementChartAppend(id, def.samples);
+  }
+};
+
+SimplyPebble.elementChartAppend = function(id, samples) {
+  if (!samples.length) { return; }
+  SimplyPebble.sendPacket(ElementChartAppendPacket.id(id).numSamples(samples.length).samples(samples));
+};
+
 SimplyPebble.elementAnimate = function(id, def, animateDef, duration, easing) {
   ElementAnimatePacket
     .id(id)
@@ -1303,30 +1662,75 @@ SimplyPebble.stageClear = function() {
   SimplyPebble.sendPacket(StageClearPacket);
 };
 
-SimplyPebble.stageElement = function(id, type, def, index) {
+SimplyPebble.stageElement = function(id, type, def, index, parent) {
+  var flags = 0;
   if (index !== undefined) {
-    SimplyPebble.elementInsert(id, type, index);
+    flags |= elementDefineFlagMap.insert;
+  }
+  if (def.static) {
+    flags |= elementDefineFlagMap.static;
   }
-  SimplyPebble.elementCommon(id, def);
+  ElementDefinePacket
+    .id(id)
+    .type(type)
+    .index(index || 0)
+    .parent(parent || 0)
+    .position(def.position)
+    .size(def.size)
+    .backgroundColor(def.backgroundColor || 'clear')
+    .borderColor(def.borderColor || 'clear');
+  var font = '';
+  var text = '';
   switch (type) {
     case StageElement.RectType:
     case StageElement.CircleType:
-      SimplyPebble.elementRadius(id, def.radius);
+      flags |= elementDefineFlagMap.radius;
       break;
     case StageElement.TextType:
-      SimplyPebble.elementRadius(id, def.radius);
-      SimplyPebble.elementTextStyle(id, def);
-      SimplyPebble.elementText(id, def.text, def.updateTimeUnits);
+      flags |= elementDefineFlagMap.radius | elementDefineFlagMap.textStyle | elementDefineFlagMap.text;
+      ElementDefinePacket
+        .color(def.color || 'clear')
+        .textOverflow(def.textOverflow || 'wrap')
+        .textAlign(def.textAlign || 'left')
+        .updateTimeUnits(def.updateTimeUnits);
+      font = Font(def.font);
+      text = def.text;
       break;
     case StageElement.ImageType:
-      SimplyPebble.elementRadius(id, def.radius);
-      SimplyPebble.elementImage(id, def.image, def.compositing);
+      flags |= elementDefineFlagMap.radius | elementDefineFlagMap.image;
+      ElementDefinePacket
+        .image(def.image)
+        .compositing(def.compositing || 'normal');
       break;
   }
+  ElementDefinePacket
+    .flags(flags)
+    .radius(def.radius)
+    .customFont(typeof font === 'number' ? font : 0)
+    .systemFont(typeof font === 'number' ? '' : font)
+    .text(text);
+  SimplyPebble.sendPacket(ElementDefinePacket);
+  if (index !== undefined) {
+    if (type === StageElement.PathType) {
+      SimplyPebble.elementPath(id, def);
+    } else if (type === StageElement.ChartType) {
+      SimplyPebble.elementChart(id, def);
+    }
+  }
 };
 
 SimplyPebble.stageRemove = SimplyPebble.elementRemove;
 
+SimplyPebble.stageMove = SimplyPebble.elementMove;
+
+SimplyPebble.stagePath = SimplyPebble.elementPath;
+
+SimplyPebble.stagePathAppend = SimplyPebble.elementPathAppend;
+
+SimplyPebble.stageChart = SimplyPebble.elementChart;
+
+SimplyPebble.stageChartAppend = SimplyPebble.elementChartAppend;
+
 SimplyPebble.stageAnimate = SimplyPebble.elementAnimate;
 
 SimplyPebble.stage = function(def, clear, pushing) {
@@ -1406,6 +1810,17 @@ SimplyPebble.onAccelData = function(packet) {
   }
 };
 
+SimplyPebble.onImageStoreHashes = function(packet) {
+  var hashes = [];
+  ImageHash._view = packet._view;
+  ImageHash._offset = packet._offset + packet._size;
+  for (var i = 0, ii = packet.numHashes(); i < ii; ++i) {
+    hashes.push(ImageHash.hash());
+    ImageHash._offset += ImageHash._size;
+  }
+  ImageService.setStoredHashes(hashes);
+};
+
 SimplyPebble.onPacket = function(buffer, offset) {
   Packet._view = buffer;
   Packet._offset = offset;
@@ -1428,8 +1843,19 @@ SimplyPebble.onPacket = function(buffer, offset) {
     case WakeupEventPacket:
       Wakeup.emitWakeup(packet.id(), packet.cookie());
       break;
+    case ImageStoreHashesPacket:
+      SimplyPebble.onImageStoreHashes(packet);
+      break;
+    case ImageMissPacket:
+      ImageService.onMiss(packet.id(), packet.hash());
+      break;
+    case ImageEvictedPacket:
+      ImageService.markUnloaded(packet.id());
+      break;
+    case ImageFormatsPacket:
+      ImageService.setFormats(packet.formats());
+      break;
     case WindowHideEventPacket:
-      ImageService.markAllUnloaded();
       WindowStack.emitHide(packet.id());
       break;
     case ClickPacket:
@@ -1450,6 +1876,9 @@ SimplyPebble.onPacket = function(buffer, offset) {
     case MenuGetItemPacket:
       Menu.emitItem(packet.section(), packet.item());
       break;
+    case MenuGetItemRangePacket:
+      Menu.emitItemRange(packet.section(), packet.item(), packet.numItems());
+      break;
     case MenuSelectPacket:
       Menu.emitSelect('menuSelect', packet.section(), packet.item());
       break;
@@ -13,6 +13,9 @@ Stage.CircleType = 2;
 Stage.TextType = 3;
 Stage.ImageType = 4;
 Stage.InverterType = 5;
+Stage.GroupType = 6;
+Stage.PathType = 7;
+Stage.ChartType = 8;
 
 util2.copy(Emitter.prototype, Stage.prototype);
 
@@ -45,6 +48,9 @@ Stage.prototype.index = function(element) {
 Stage.prototype._insert = function(index, element) {
   if (this === WindowStack.top()) {
     simply.impl.stageElement(element._id(), element._type(), element.state, index);
+    if (element._load) {
+      element._load();
+    }
   }
 };
 
@@ -53,6 +59,33 @@ Stage.prototype._remove = function(element, broadcast) {
   if (this === WindowStack.top()) {
     simply.impl.stageRemove(element._id());
   }
+  element._reset();
+};
+
+Stage.prototype._move = function(element, position, sibling) {
+  if (this === WindowStack.top()) {
+    simply.impl.stageMove(element._id(), position, sibling && sibling._id());
+  }
+};
+
+Stage.prototype.move = function(element, position, sibling) {
+  var index = this.index(element);
+  var isRelative = (position === 'above' || position === 'below');
+  if (index === -1 || (isRelative && (!sibling || sibling === element || this.index(sibling) === -1))) {
+    return this;
+  }
+  this._items.splice(index, 1);
+  switch (position) {
+    case 'front': this._items.push(element); break;
+    case 'back': this._items.unshift(element); break;
+    case 'above': this._items.splice(this.index(sibling) + 1, 0, element); break;
+    case 'below': this._items.splice(this.index(sibling), 0, element); break;
+    default:
+      this._items.splice(index, 0, element);
+      return this;
+  }
+  this._move(element, position, sibling);
+  return this;
 };
 
 Stage.prototype.insert = function(index, element) {
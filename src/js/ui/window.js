@@ -86,11 +86,17 @@ Window.prototype.hide = function() {
 };
 
 Window.prototype._show = function(pushing) {
+  if (simply.impl.batchBegin) {
+    simply.impl.batchBegin();
+  }
   this._prop(this.state, true, pushing || false);
   this._buttonConfig({});
   if (this._dynamic) {
     Stage.prototype._show.call(this, pushing);
   }
+  if (simply.impl.batchCommit) {
+    simply.impl.batchCommit();
+  }
 };
 
 Window.prototype.show = function() {
@@ -1,6 +1,7 @@
 #include "simply.h"
 
 #include "simply_accel.h"
+#include "simply_batch.h"
 #include "simply_res.h"
 #include "simply_splash.h"
 #include "simply_stage.h"
@@ -16,6 +17,7 @@
 Simply *simply_init(void) {
   Simply *simply = malloc(sizeof(*simply));
   simply->accel = simply_accel_create(simply);
+  simply->batch = simply_batch_create(simply);
   simply->voice = simply_voice_create(simply);
   simply->res = simply_res_create(simply);
   simply->splash = simply_splash_create(simply);
@@ -40,6 +42,7 @@ void simply_deinit(Simply *simply) {
   simply_menu_destroy(simply->menu);
   simply_stage_destroy(simply->stage);
   simply_res_destroy(simply->res);
+  simply_batch_destroy(simply->batch);
   simply_accel_destroy(simply->accel);
   simply_voice_destroy(simply->voice);
   free(simply);
@@ -6,6 +6,7 @@ typedef struct Simply Simply;
 
 struct Simply {
   struct SimplyAccel *accel;
+  struct SimplyBatch *batch;
   struct SimplyVoice *voice;
   struct SimplyRes *res;
   struct SimplyMsg *msg;
@@ -0,0 +1,100 @@
+#include "simply_batch.h"
+
+#include "simply_msg.h"
+
+#include "simply.h"
+
+#include <pebble.h>
+
+static const uint32_t BATCH_TIMEOUT_MS = 1000;
+
+typedef Packet BatchBeginPacket;
+
+typedef Packet BatchCommitPacket;
+
+static void timeout_timer_callback(void *data) {
+  SimplyBatch *self = data;
+  self->timeout_timer = NULL;
+  simply_batch_commit(self);
+}
+
+void simply_batch_begin(SimplyBatch *self) {
+  self->is_open = true;
+  if (self->timeout_timer) {
+    app_timer_cancel(self->timeout_timer);
+  }
+  self->timeout_timer = app_timer_register(BATCH_TIMEOUT_MS, timeout_timer_callback, self);
+}
+
+void simply_batch_commit(SimplyBatch *self) {
+  if (self->timeout_timer) {
+    app_timer_cancel(self->timeout_timer);
+    self->timeout_timer = NULL;
+  }
+  self->is_open = false;
+  const uint8_t num_deferred = self->num_deferred;
+  self->num_deferred = 0;
+  for (uint8_t i = 0; i < num_deferred; ++i) {
+    SimplyBatchEntry *entry = &self->deferred[i];
+    entry->callback(entry->context);
+  }
+}
+
+bool simply_batch_defer(SimplyBatch *self, SimplyBatchCallback callback, void *context) {
+  if (!self || !self->is_open) {
+    return false;
+  }
+  for (uint8_t i = 0; i < self->num_deferred; ++i) {
+    SimplyBatchEntry *entry = &self->deferred[i];
+    if (entry->callback == callback && entry->context == context) {
+      return true;
+    }
+  }
+  if (self->num_deferred >= SIMPLY_BATCH_MAX_DEFERRED) {
+    return false;
+  }
+  self->deferred[self->num_deferred++] = (SimplyBatchEntry) {
+    .callback = callback,
+    .context = context,
+  };
+  return true;
+}
+
+static void handle_batch_begin_packet(Simply *simply, Packet *data) {
+  simply_batch_begin(simply->batch);
+}
+
+static void handle_batch_commit_packet(Simply *simply, Packet *data) {
+  simply_batch_commit(simply->batch);
+}
+
+bool simply_batch_handle_packet(Simply *simply, Packet *packet) {
+  switch (packet->type) {
+    case CommandBatchBegin:
+      handle_batch_begin_packet(simply, packet);
+      return true;
+    case CommandBatchCommit:
+      handle_batch_commit_packet(simply, packet);
+      return true;
+  }
+  return false;
+}
+
+SimplyBatch *simply_batch_create(Simply *simply) {
+  SimplyBatch *self = malloc(sizeof(*self));
+  *self = (SimplyBatch) { .simply = simply };
+  return self;
+}
+
+void simply_batch_destroy(SimplyBatch *self) {
+  if (!self) {
+    return;
+  }
+
+  if (self->timeout_timer) {
+    app_timer_cancel(self->timeout_timer);
+    self->timeout_timer = NULL;
+  }
+
+  free(self);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "simply_msg.h"
+
+#include "simply.h"
+
+#include <pebble.h>
+
+#define SIMPLY_BATCH_MAX_DEFERRED 8
+
+typedef void (*SimplyBatchCallback)(void *context);
+
+typedef struct SimplyBatchEntry SimplyBatchEntry;
+
+struct SimplyBatchEntry {
+  SimplyBatchCallback callback;
+  void *context;
+};
+
+typedef struct SimplyBatch SimplyBatch;
+
+struct SimplyBatch {
+  Simply *simply;
+  AppTimer *timeout_timer;
+  SimplyBatchEntry deferred[SIMPLY_BATCH_MAX_DEFERRED];
+  uint8_t num_deferred;
+  bool is_open;
+};
+
+SimplyBatch *simply_batch_create(Simply *simply);
+void simply_batch_destroy(SimplyBatch *self);
+
+void simply_batch_begin(SimplyBatch *self);
+void simply_batch_commit(SimplyBatch *self);
+
+//! Defers a redraw callback until the open batch is committed.
+//! Returns false if no batch is open, in which case the caller should apply the update now.
+bool simply_batch_defer(SimplyBatch *self, SimplyBatchCallback callback, void *context);
+
+bool simply_batch_handle_packet(Simply *simply, Packet *packet);
@@ -0,0 +1,166 @@
+#include "simply_image_store.h"
+
+#include "util/math.h"
+
+#include <pebble.h>
+
+#define IMAGE_STORE_VERSION 2
+
+//! The index lives at this key and the payload chunks of entry n at the keys that follow it
+#define IMAGE_STORE_INDEX_KEY 0x494D4700
+
+#define CHUNKS_PER_ENTRY ((IMAGE_STORE_MAX_SIZE + PERSIST_DATA_MAX_LENGTH - 1) / PERSIST_DATA_MAX_LENGTH)
+
+typedef struct SimplyImageStoreIndex SimplyImageStoreIndex;
+
+//! Entries with a zero hash are free
+struct __attribute__((__packed__)) SimplyImageStoreIndex {
+  uint8_t version;
+  uint16_t clock;
+  SimplyImageStoreEntry entries[IMAGE_STORE_MAX_ENTRIES];
+};
+
+static SimplyImageStoreIndex s_index;
+static bool s_is_index_loaded = false;
+
+static SimplyImageStoreIndex *get_index(void) {
+  if (!s_is_index_loaded) {
+    s_is_index_loaded = true;
+    if (persist_read_data(IMAGE_STORE_INDEX_KEY, &s_index, sizeof(s_index)) != sizeof(s_index) ||
+        s_index.version != IMAGE_STORE_VERSION) {
+      s_index = (SimplyImageStoreIndex) { .version = IMAGE_STORE_VERSION };
+    }
+  }
+  return &s_index;
+}
+
+static void write_index(SimplyImageStoreIndex *index) {
+  persist_write_data(IMAGE_STORE_INDEX_KEY, index, sizeof(*index));
+}
+
+static uint32_t chunk_key(int slot, int chunk) {
+  return IMAGE_STORE_INDEX_KEY + 1 + slot * CHUNKS_PER_ENTRY + chunk;
+}
+
+static int find_slot(SimplyImageStoreIndex *index, uint32_t hash) {
+  for (int slot = 0; slot < IMAGE_STORE_MAX_ENTRIES; ++slot) {
+    if (index->entries[slot].hash == hash) {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+static int find_oldest_slot(SimplyImageStoreIndex *index) {
+  int oldest = -1;
+  uint16_t oldest_age = 0;
+  for (int slot = 0; slot < IMAGE_STORE_MAX_ENTRIES; ++slot) {
+    SimplyImageStoreEntry *entry = &index->entries[slot];
+    const uint16_t age = index->clock - entry->used_at;
+    if (entry->hash && (oldest < 0 || age > oldest_age)) {
+      oldest = slot;
+      oldest_age = age;
+    }
+  }
+  return oldest;
+}
+
+static size_t get_used_size(SimplyImageStoreIndex *index) {
+  size_t size = 0;
+  for (int slot = 0; slot < IMAGE_STORE_MAX_ENTRIES; ++slot) {
+    if (index->entries[slot].hash) {
+      size += index->entries[slot].length;
+    }
+  }
+  return size;
+}
+
+static void delete_chunks(int slot, uint16_t length) {
+  for (int chunk = 0; chunk * PERSIST_DATA_MAX_LENGTH < length; ++chunk) {
+    persist_delete(chunk_key(slot, chunk));
+  }
+}
+
+static void delete_entry(SimplyImageStoreIndex *index, int slot) {
+  delete_chunks(slot, index->entries[slot].length);
+  index->entries[slot] = (SimplyImageStoreEntry) { .hash = 0 };
+}
+
+bool simply_image_store_save(uint32_t hash, uint8_t format, int16_t width, int16_t height,
+                             const uint8_t *data, uint16_t length) {
+  if (!hash || !data || !length || length > IMAGE_STORE_MAX_SIZE) {
+    return false;
+  }
+
+  SimplyImageStoreIndex *index = get_index();
+  if (find_slot(index, hash) >= 0) {
+    return true;
+  }
+
+  // Evict the least recently used payloads until there is a free entry and enough room
+  int slot;
+  while ((slot = find_slot(index, 0)) < 0 || get_used_size(index) + length > IMAGE_STORE_CAPACITY) {
+    delete_entry(index, find_oldest_slot(index));
+  }
+
+  for (uint16_t offset = 0; offset < length; offset += PERSIST_DATA_MAX_LENGTH) {
+    const int size = MIN(PERSIST_DATA_MAX_LENGTH, length - offset);
+    if (persist_write_data(chunk_key(slot, offset / PERSIST_DATA_MAX_LENGTH), data + offset, size) != size) {
+      delete_chunks(slot, offset + size);
+      write_index(index);
+      return false;
+    }
+  }
+
+  index->entries[slot] = (SimplyImageStoreEntry) {
+    .hash = hash,
+    .format = format,
+    .width = width,
+    .height = height,
+    .length = length,
+    .used_at = ++index->clock,
+  };
+  write_index(index);
+  return true;
+}
+
+//! Reads a stored payload into a new buffer that the caller frees
+uint8_t *simply_image_store_load(uint32_t hash, SimplyImageStoreEntry *entry_out) {
+  SimplyImageStoreIndex *index = get_index();
+  const int slot = hash ? find_slot(index, hash) : -1;
+  if (slot < 0) {
+    return NULL;
+  }
+
+  SimplyImageStoreEntry *entry = &index->entries[slot];
+  uint8_t *data = malloc(entry->length);
+  if (!data) {
+    return NULL;
+  }
+
+  for (uint16_t offset = 0; offset < entry->length; offset += PERSIST_DATA_MAX_LENGTH) {
+    const int size = MIN(PERSIST_DATA_MAX_LENGTH, entry->length - offset);
+    if (persist_read_data(chunk_key(slot, offset / PERSIST_DATA_MAX_LENGTH), data + offset, size) != size) {
+      free(data);
+      delete_entry(index, slot);
+      write_index(index);
+      return NULL;
+    }
+  }
+
+  entry->used_at = ++index->clock;
+  write_index(index);
+  *entry_out = *entry;
+  return data;
+}
+
+size_t simply_image_store_get_hashes(uint32_t *hashes, size_t max_hashes) {
+  SimplyImageStoreIndex *index = get_index();
+  size_t num_hashes = 0;
+  for (int slot = 0; slot < IMAGE_STORE_MAX_ENTRIES && num_hashes < max_hashes; ++slot) {
+    if (index->entries[slot].hash) {
+      hashes[num_hashes++] = index->entries[slot].hash;
+    }
+  }
+  return num_hashes;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <pebble.h>
+
+//! Persistent cache of image payloads received from JS, keyed by a content hash that JS computes.
+//! Payloads are kept exactly as they were sent along with their format, so that they can be added again
+//! with simply_res_add_image on a later launch without being transferred.
+
+#define IMAGE_STORE_MAX_ENTRIES 8
+//! Largest payload that is stored, which keeps a few icons and logos within the 4KB app storage
+#define IMAGE_STORE_MAX_SIZE 2048
+//! Bytes that all stored payloads may use together
+#define IMAGE_STORE_CAPACITY 3072
+
+typedef struct SimplyImageStoreEntry SimplyImageStoreEntry;
+
+struct __attribute__((__packed__)) SimplyImageStoreEntry {
+  uint32_t hash;
+  uint8_t format;
+  int16_t width;
+  int16_t height;
+  uint16_t length;
+  uint16_t used_at;
+};
+
+bool simply_image_store_save(uint32_t hash, uint8_t format, int16_t width, int16_t height,
+                             const uint8_t *data, uint16_t length);
+uint8_t *simply_image_store_load(uint32_t hash, SimplyImageStoreEntry *entry_out);
+size_t simply_image_store_get_hashes(uint32_t *hashes, size_t max_hashes);
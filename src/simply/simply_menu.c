@@ -1,5 +1,6 @@
 #include "simply_menu.h"
 
+#include "simply_batch.h"
 #include "simply_res.h"
 #include "simply_msg.h"
 #include "simply_window_stack.h"
@@ -8,15 +9,38 @@
 
 #include "util/color.h"
 #include "util/graphics.h"
+#include "util/math.h"
+#include "util/memory.h"
 #include "util/menu_layer.h"
 #include "util/platform.h"
 #include "util/string.h"
 
 #include <pebble.h>
 
-#define MAX_CACHED_SECTIONS 10
+//! Cache capacities start at the initial size and adapt to the free heap between the minimum and maximum
+#define INITIAL_CACHED_SECTIONS 10
+#define MIN_CACHED_SECTIONS 4
+#define MAX_CACHED_SECTIONS IF_APLITE_ELSE(16, 32)
 
-#define MAX_CACHED_ITEMS IF_APLITE_ELSE(6, 51)
+//! The item cache never shrinks below the up to 5 rows on screen plus the prefetch window of a third
+//! of the cache. Otherwise requesting a missing row evicts another visible row, whose redraw then
+//! requests it again, and the menu never settles.
+#define INITIAL_CACHED_ITEMS IF_APLITE_ELSE(8, 51)
+#define MIN_CACHED_ITEMS IF_APLITE_ELSE(8, 16)
+#define MAX_CACHED_ITEMS IF_APLITE_ELSE(24, 128)
+
+//! Caches shrink below the low watermark of free heap and grow above the high watermark
+#define HEAP_LOW_WATERMARK IF_APLITE_ELSE(2048, 8192)
+#define HEAP_HIGH_WATERMARK IF_APLITE_ELSE(6144, 24576)
+
+//! Number of item nodes allocated together by the item pool
+#define ITEM_SLAB_SIZE IF_APLITE_ELSE(3, 8)
+
+//! Smallest text arena allocated for a section
+#define MIN_ARENA_SIZE IF_APLITE_ELSE(128, 512)
+
+//! Most rows requested at once ahead of the selection, further limited to a third of the item cache
+#define MAX_PREFETCH_ITEMS 16
 
 static const time_t SPINNER_MS = 66;
 
@@ -50,6 +74,24 @@ struct __attribute__((__packed__)) MenuSectionPacket {
   char title[];
 };
 
+typedef struct MenuSectionRecord MenuSectionRecord;
+
+//! A section in a MenuSectionsPacket, followed by the next record
+struct __attribute__((__packed__)) MenuSectionRecord {
+  uint16_t num_items;
+  uint16_t title_length;
+  char title[];
+};
+
+typedef struct MenuSectionsPacket MenuSectionsPacket;
+
+//! Metadata of the sections starting from the first one
+struct __attribute__((__packed__)) MenuSectionsPacket {
+  Packet packet;
+  uint16_t num_sections;
+  uint8_t records[];
+};
+
 typedef struct MenuItemPacket MenuItemPacket;
 
 struct __attribute__((__packed__)) MenuItemPacket {
@@ -70,6 +112,35 @@ struct __attribute__((__packed__)) MenuItemEventPacket {
   uint16_t item;
 };
 
+typedef struct MenuGetItemRangePacket MenuGetItemRangePacket;
+
+struct __attribute__((__packed__)) MenuGetItemRangePacket {
+  Packet packet;
+  uint16_t section;
+  uint16_t item;
+  uint16_t num_items;
+};
+
+typedef struct MenuItemRecord MenuItemRecord;
+
+//! An item in a MenuItemsPacket, followed by the next record
+struct __attribute__((__packed__)) MenuItemRecord {
+  uint16_t item;
+  uint32_t icon;
+  uint16_t title_length;
+  uint16_t subtitle_length;
+  char buffer[];
+};
+
+typedef struct MenuItemsPacket MenuItemsPacket;
+
+struct __attribute__((__packed__)) MenuItemsPacket {
+  Packet packet;
+  uint16_t section;
+  uint16_t num_items;
+  uint8_t records[];
+};
+
 typedef Packet MenuGetSelectionPacket;
 
 typedef struct MenuSelectionPacket MenuSelectionPacket;
@@ -88,6 +159,13 @@ static GColor8 s_inverted_palette[] = { { GColorWhiteARGB8 }, { GColorClearARGB8
 
 static char EMPTY_TITLE[] = "";
 
+typedef struct SimplyMenuItemSlab SimplyMenuItemSlab;
+
+struct SimplyMenuItemSlab {
+  List1Node node;
+  SimplyMenuItem items[ITEM_SLAB_SIZE];
+};
+
 
 static void simply_menu_clear_section_items(SimplyMenu *self, int section_index);
 static void simply_menu_clear(SimplyMenu *self);
@@ -123,8 +201,15 @@ static bool send_menu_get_section(uint16_t index) {
   return send_menu_item(CommandMenuGetSection, index, 0);
 }
 
-static bool send_menu_get_item(uint16_t section, uint16_t index) {
-  return send_menu_item(CommandMenuGetItem, section, index);
+static bool send_menu_get_item_range(uint16_t section, uint16_t index, uint16_t num_items) {
+  MenuGetItemRangePacket packet = {
+    .packet.type = CommandMenuGetItemRange,
+    .packet.length = sizeof(packet),
+    .section = section,
+    .item = index,
+    .num_items = num_items,
+  };
+  return simply_msg_send_packet(&packet.packet);
 }
 
 static bool send_menu_select_click(uint16_t section, uint16_t index) {
@@ -135,32 +220,77 @@ static bool send_menu_select_long_click(uint16_t section, uint16_t index) {
   return send_menu_item(CommandMenuLongSelect, section, index);
 }
 
-static bool section_filter(List1Node *node, void *data) {
-  SimplyMenuCommon *section = (SimplyMenuCommon*) node;
-  uint16_t section_index = (uint16_t)(uintptr_t) data;
-  return (section->section == section_index);
+static uint32_t item_key(uint16_t section, uint16_t item) {
+  return section | ((uint32_t) item << 16);
+}
+
+static void cache_init(SimplyMenuCache *cache, SimplyMenuCommon **buckets, uint16_t num_buckets,
+                       uint16_t capacity, uint16_t min_capacity, uint16_t max_capacity) {
+  *cache = (SimplyMenuCache) {
+    .buckets = buckets,
+    .num_buckets = num_buckets,
+    .capacity = capacity,
+    .min_capacity = min_capacity,
+    .max_capacity = max_capacity,
+  };
+}
+
+static void cache_adapt_capacity(SimplyMenuCache *cache, bool is_pressured, size_t bytes_free) {
+  if (is_pressured || bytes_free < HEAP_LOW_WATERMARK) {
+    cache->capacity = MAX(cache->capacity / 2, cache->min_capacity);
+  } else if (bytes_free > HEAP_HIGH_WATERMARK) {
+    cache->capacity = MIN(cache->capacity + cache->capacity / 4 + 1, cache->max_capacity);
+  }
+}
+
+static SimplyMenuCommon **cache_bucket(SimplyMenuCache *cache, uint32_t key) {
+  // Fibonacci hashing spreads consecutive sections and rows across the buckets
+  return &cache->buckets[((key * 2654435761u) >> 16) & (cache->num_buckets - 1)];
 }
 
-static bool item_filter(List1Node *node, void *data) {
-  SimplyMenuItem *item = (SimplyMenuItem*) node;
-  uint32_t cell_index = (uint32_t)(uintptr_t) data;
-  uint16_t section_index = cell_index;
-  uint16_t row = cell_index >> 16;
-  return (item->section == section_index && item->item == row);
+static SimplyMenuCommon *cache_get(SimplyMenuCache *cache, uint32_t key) {
+  for (SimplyMenuCommon *walk = *cache_bucket(cache, key); walk; walk = walk->bucket_next) {
+    if (walk->key == key) {
+      return walk;
+    }
+  }
+  return NULL;
 }
 
-static bool request_item_filter(List1Node *node, void *data) {
-  SimplyMenuItem *item = (SimplyMenuItem*) node;
-  return (item->title == NULL);
+static void cache_link(SimplyMenuCache *cache, SimplyMenuCommon *entry) {
+  SimplyMenuCommon **bucket = cache_bucket(cache, entry->key);
+  entry->bucket_next = *bucket;
+  *bucket = entry;
+  list2_prepend(&cache->lru, &entry->node);
+  cache->size++;
+}
+
+static void cache_unlink(SimplyMenuCache *cache, SimplyMenuCommon *entry) {
+  if (!list2_remove(&cache->lru, &entry->node)) {
+    return;
+  }
+  for (SimplyMenuCommon **ref = cache_bucket(cache, entry->key); *ref; ref = &(*ref)->bucket_next) {
+    if (*ref == entry) {
+      *ref = entry->bucket_next;
+      break;
+    }
+  }
+  entry->bucket_next = NULL;
+  cache->size--;
+}
+
+static void cache_promote(SimplyMenuCache *cache, SimplyMenuCommon *entry) {
+  list2_remove(&cache->lru, &entry->node);
+  list2_prepend(&cache->lru, &entry->node);
 }
 
 static SimplyMenuSection *get_menu_section(SimplyMenu *self, int index) {
-  return (SimplyMenuSection*) list1_find(self->menu_layer.sections, section_filter, (void*)(uintptr_t) index);
+  return (SimplyMenuSection*) cache_get(&self->menu_layer.sections, index);
 }
 
 static void destroy_section(SimplyMenu *self, SimplyMenuSection *section) {
   if (!section) { return; }
-  list1_remove(&self->menu_layer.sections, &section->node);
+  cache_unlink(&self->menu_layer.sections, &section->common);
   if (section->title && section->title != EMPTY_TITLE) {
     free(section->title);
     section->title = NULL;
@@ -168,50 +298,206 @@ static void destroy_section(SimplyMenu *self, SimplyMenuSection *section) {
   free(section);
 }
 
-static void destroy_section_by_index(SimplyMenu *self, int section) {
-  destroy_section(self, (SimplyMenuSection*) list1_find(
-        self->menu_layer.sections, section_filter, (void*)(uintptr_t) section));
+static SimplyMenuItem *get_menu_item(SimplyMenu *self, int section, int index) {
+  return (SimplyMenuItem*) cache_get(&self->menu_layer.items, item_key(section, index));
 }
 
-static SimplyMenuItem *get_menu_item(SimplyMenu *self, int section, int index) {
-  uint32_t cell_index = section | (index << 16);
-  return (SimplyMenuItem*) list1_find(self->menu_layer.items, item_filter, (void*)(uintptr_t) cell_index);
+static void *malloc_or_evict(SimplyMenu *self, size_t size) {
+  void *buffer = NULL;
+  while (!(buffer = malloc(size))) {
+    if (!simply_res_evict_image(self->window.simply->res)) {
+      return NULL;
+    }
+  }
+  return buffer;
 }
 
-static void destroy_item(SimplyMenu *self, SimplyMenuItem *item) {
-  if (!item) { return; }
-  list1_remove(&self->menu_layer.items, &item->node);
-  if (item->title) {
-    free(item->title);
-    item->title = NULL;
+static SimplyMenuItem *alloc_item(SimplyMenu *self) {
+  SimplyMenuLayer *menu_layer = &self->menu_layer;
+  if (!menu_layer->free_items) {
+    SimplyMenuItemSlab *slab = malloc_or_evict(self, sizeof(*slab));
+    if (!slab) {
+      return NULL;
+    }
+    list1_prepend(&menu_layer->item_slabs, &slab->node);
+    for (int i = 0; i < ITEM_SLAB_SIZE; i++) {
+      slab->items[i].bucket_next = menu_layer->free_items;
+      menu_layer->free_items = &slab->items[i].common;
+    }
+  }
+  SimplyMenuItem *item = (SimplyMenuItem*) menu_layer->free_items;
+  menu_layer->free_items = item->bucket_next;
+  return item;
+}
+
+static void free_item(SimplyMenu *self, SimplyMenuItem *item) {
+  item->bucket_next = self->menu_layer.free_items;
+  self->menu_layer.free_items = &item->common;
+}
+
+//! Frees the item pool, which requires that no items remain
+static void destroy_item_pool(SimplyMenu *self) {
+  while (self->menu_layer.item_slabs) {
+    free(list1_remove(&self->menu_layer.item_slabs, self->menu_layer.item_slabs));
+  }
+  self->menu_layer.free_items = NULL;
+}
+
+static size_t text_size(const char *text) {
+  return (text && text != EMPTY_TITLE) ? strlen(text) + 1 : 0;
+}
+
+static size_t item_text_size(SimplyMenuItem *item) {
+  return text_size(item->title) + text_size(item->subtitle);
+}
+
+static bool arena_filter(List1Node *node, void *data) {
+  return (((SimplyMenuArena*) node)->section == (uint16_t)(uintptr_t) data);
+}
+
+static SimplyMenuArena *get_arena(SimplyMenu *self, uint16_t section) {
+  return (SimplyMenuArena*) list1_find(self->menu_layer.item_arenas, arena_filter, (void*)(uintptr_t) section);
+}
+
+static char *arena_copy(SimplyMenuArena *arena, const char *text) {
+  const size_t size = text_size(text);
+  if (!size) {
+    return (char*) text;
+  }
+  char *copy = arena->buffer + arena->used;
+  memcpy(copy, text, size);
+  arena->used += size;
+  arena->live += size;
+  return copy;
+}
+
+//! Moves the text of the cached items of a section into a new arena with room for size more bytes
+static SimplyMenuArena *compact_arena(SimplyMenu *self, SimplyMenuArena *arena, uint16_t section,
+                                      size_t size) {
+  const size_t live = arena ? arena->live : 0;
+  const size_t arena_size = MAX(MIN_ARENA_SIZE, (live + size) * 2);
+  if (arena_size > UINT16_MAX) {
+    return NULL;
+  }
+  SimplyMenuArena *copy = malloc_or_evict(self, sizeof(*copy) + arena_size);
+  if (!copy) {
+    return NULL;
+  }
+  *copy = (SimplyMenuArena) {
+    .section = section,
+    .size = arena_size,
+  };
+  if (arena) {
+    copy->num_items = arena->num_items;
+    for (List2Node *walk = self->menu_layer.items.lru.head; walk; walk = walk->next) {
+      SimplyMenuItem *item = (SimplyMenuItem*) walk;
+      if (item->section == section) {
+        item->title = arena_copy(copy, item->title);
+        item->subtitle = arena_copy(copy, item->subtitle);
+      }
+    }
+    list1_remove(&self->menu_layer.item_arenas, &arena->node);
+    free(arena);
+  }
+  list1_prepend(&self->menu_layer.item_arenas, &copy->node);
+  return copy;
+}
+
+//! Copies the text of an item into the arena of its section, which the item keeps alive until destroyed
+static bool set_item_text(SimplyMenu *self, SimplyMenuItem *item, const char *title, const char *subtitle) {
+  const size_t size = text_size(title) + text_size(subtitle);
+  if (!size) {
+    return true;
+  }
+  SimplyMenuArena *arena = get_arena(self, item->section);
+  if (!arena || arena->used + size > arena->size) {
+    if (!(arena = compact_arena(self, arena, item->section, size))) {
+      return false;
+    }
+  }
+  arena->num_items++;
+  item->title = arena_copy(arena, title);
+  item->subtitle = arena_copy(arena, subtitle);
+  return true;
+}
+
+static void release_item_text(SimplyMenu *self, SimplyMenuItem *item) {
+  const size_t size = item_text_size(item);
+  SimplyMenuArena *arena = size ? get_arena(self, item->section) : NULL;
+  if (!arena) {
+    return;
   }
-  if (item->subtitle) {
-    free(item->subtitle);
-    item->subtitle = NULL;
+  arena->live -= size;
+  if (--arena->num_items == 0) {
+    list1_remove(&self->menu_layer.item_arenas, &arena->node);
+    free(arena);
   }
-  free(item);
 }
 
-static void destroy_item_by_index(SimplyMenu *self, int section, int index) {
-  uint32_t cell_index = section | (index << 16);
-  destroy_item(self, (SimplyMenuItem*) list1_find(
-        self->menu_layer.items, item_filter, (void*)(uintptr_t) cell_index));
+static SimplyMenuItem *create_item(SimplyMenu *self, uint16_t section, uint16_t index, uint32_t icon,
+                                   const char *title, const char *subtitle) {
+  SimplyMenuItem *item = alloc_item(self);
+  if (!item) {
+    return NULL;
+  }
+  *item = (SimplyMenuItem) {
+    .section = section,
+    .item = index,
+    .icon = icon,
+  };
+  if (!set_item_text(self, item, title, subtitle)) {
+    free_item(self, item);
+    return NULL;
+  }
+  simply_res_pin_image(self->window.simply->res, icon);
+  return item;
+}
+
+static void destroy_item(SimplyMenu *self, SimplyMenuItem *item) {
+  if (!item) { return; }
+  cache_unlink(&self->menu_layer.items, &item->common);
+  release_item_text(self, item);
+  simply_res_unpin_image(self->window.simply->res, item->icon);
+  free_item(self, item);
+}
+
+//! Resizes the caches when one of them is full or images were evicted since the last time.
+//! Image evictions mean that allocations failed, so both caches shrink regardless of the free heap.
+static void adapt_cache_capacities(SimplyMenu *self) {
+  SimplyMenuLayer *menu_layer = &self->menu_layer;
+  const uint16_t num_evictions = self->window.simply->res->num_evictions;
+  const bool is_pressured = (num_evictions != menu_layer->num_evictions);
+  const bool is_full = (menu_layer->sections.size >= menu_layer->sections.capacity ||
+                        menu_layer->items.size >= menu_layer->items.capacity);
+  if (!is_pressured && !is_full) {
+    return;
+  }
+  menu_layer->num_evictions = num_evictions;
+  const size_t bytes_free = heap_bytes_free();
+  cache_adapt_capacity(&menu_layer->sections, is_pressured, bytes_free);
+  cache_adapt_capacity(&menu_layer->items, is_pressured, bytes_free);
 }
 
 static void add_section(SimplyMenu *self, SimplyMenuSection *section) {
-  if (list1_size(self->menu_layer.sections) >= MAX_CACHED_SECTIONS) {
-    destroy_section(self, (SimplyMenuSection*) list1_last(self->menu_layer.sections));
+  SimplyMenuCache *cache = &self->menu_layer.sections;
+  section->key = section->section;
+  destroy_section(self, get_menu_section(self, section->section));
+  adapt_cache_capacities(self);
+  while (cache->size >= cache->capacity && cache->lru.tail) {
+    destroy_section(self, (SimplyMenuSection*) cache->lru.tail);
   }
-  destroy_section_by_index(self, section->section);
-  list1_prepend(&self->menu_layer.sections, &section->node);
+  cache_link(cache, &section->common);
 }
 
 static void add_item(SimplyMenu *self, SimplyMenuItem *item) {
-  if (list1_size(self->menu_layer.items) >= MAX_CACHED_ITEMS) {
-    destroy_item(self, (SimplyMenuItem*) list1_last(self->menu_layer.items));
+  SimplyMenuCache *cache = &self->menu_layer.items;
+  item->key = item_key(item->section, item->item);
+  destroy_item(self, get_menu_item(self, item->section, item->item));
+  adapt_cache_capacities(self);
+  while (cache->size >= cache->capacity && cache->lru.tail) {
+    destroy_item(self, (SimplyMenuItem*) cache->lru.tail);
   }
-  destroy_item_by_index(self, item->section, item->item);
-  list1_prepend(&self->menu_layer.items, &item->node);
+  cache_link(cache, &item->common);
 }
 
 static void request_menu_section(SimplyMenu *self, uint16_t section_index) {
@@ -220,6 +506,9 @@ static void request_menu_section(SimplyMenu *self, uint16_t section_index) {
     return;
   }
   section = malloc(sizeof(*section));
+  if (!section) {
+    return;
+  }
   *section = (SimplyMenuSection) {
     .section = section_index,
   };
@@ -227,36 +516,98 @@ static void request_menu_section(SimplyMenu *self, uint16_t section_index) {
   send_menu_get_section(section_index);
 }
 
-static void request_menu_item(SimplyMenu *self, uint16_t section_index, uint16_t item_index) {
-  SimplyMenuItem *item = get_menu_item(self, section_index, item_index);
-  if (item) {
-    return;
+static bool request_menu_item(SimplyMenu *self, uint16_t section_index, uint16_t item_index) {
+  if (get_menu_item(self, section_index, item_index)) {
+    return false;
+  }
+  SimplyMenuItem *item = create_item(self, section_index, item_index, 0, NULL, NULL);
+  if (!item) {
+    return false;
   }
-  item = malloc(sizeof(*item));
-  *item = (SimplyMenuItem) {
-    .section = section_index,
-    .item = item_index,
-  };
   add_item(self, item);
-  send_menu_get_item(section_index, item_index);
+  return true;
+}
+
+//! Requests a missing row along with the rows that the user is scrolling towards in a single range.
+//! Rows that are already cached or pending are skipped at either end of the range.
+static void request_menu_items(SimplyMenu *self, uint16_t section_index, uint16_t item_index) {
+  if (!request_menu_item(self, section_index, item_index)) {
+    return;
+  }
+  SimplyMenuSection *section = get_menu_section(self, section_index);
+  const int num_rows = section ? section->num_items : item_index + 1;
+  const int num_prefetch = MAX(MIN(MAX_PREFETCH_ITEMS, self->menu_layer.items.capacity / 3), 1);
+  const int step = (self->menu_layer.scroll_direction < 0) ? -1 : 1;
+  int first = item_index;
+  int last = item_index;
+  for (int i = 1; i < num_prefetch; i++) {
+    const int row = item_index + i * step;
+    if (row < 0 || row >= num_rows) {
+      break;
+    }
+    if (request_menu_item(self, section_index, row)) {
+      first = MIN(first, row);
+      last = MAX(last, row);
+    }
+  }
+  send_menu_get_item_range(section_index, first, last - first + 1);
 }
 
 static void mark_dirty(SimplyMenu *self) {
+  if (simply_batch_defer(self->window.simply->batch, (SimplyBatchCallback) mark_dirty, self)) {
+    return;
+  }
   if (self->menu_layer.menu_layer) {
     layer_mark_dirty(menu_layer_get_layer(self->menu_layer.menu_layer));
   }
 }
 
 static void reload_data(SimplyMenu *self) {
+  if (simply_batch_defer(self->window.simply->batch, (SimplyBatchCallback) reload_data, self)) {
+    return;
+  }
   if (self->menu_layer.menu_layer) {
     menu_layer_reload_data(self->menu_layer.menu_layer);
   }
 }
 
+static void destroy_section_infos(SimplyMenu *self) {
+  free(self->menu_layer.section_infos);
+  self->menu_layer.section_infos = NULL;
+}
+
+static SimplyMenuSectionInfo *get_section_info(SimplyMenu *self, uint16_t section_index) {
+  if (!self->menu_layer.section_infos || section_index >= self->menu_layer.num_sections) {
+    return NULL;
+  }
+  SimplyMenuSectionInfo *info = &self->menu_layer.section_infos[section_index];
+  return info->is_known ? info : NULL;
+}
+
+//! Records the metadata of a section. Returns whether the menu layout changed.
+static bool set_section_info(SimplyMenu *self, SimplyMenuSection *section) {
+  const bool has_title = (section->title && section->title != EMPTY_TITLE);
+  SimplyMenuSectionInfo *info = get_section_info(self, section->section);
+  if (info && info->num_items == section->num_items && info->has_title == has_title) {
+    return false;
+  }
+  if (self->menu_layer.section_infos && section->section < self->menu_layer.num_sections) {
+    self->menu_layer.section_infos[section->section] = (SimplyMenuSectionInfo) {
+      .num_items = section->num_items,
+      .has_title = has_title,
+      .is_known = true,
+    };
+  }
+  return true;
+}
+
 static void simply_menu_set_num_sections(SimplyMenu *self, uint16_t num_sections) {
   if (num_sections == 0) {
     num_sections = 1;
   }
+  if (num_sections != self->menu_layer.num_sections) {
+    destroy_section_infos(self);
+  }
   self->menu_layer.num_sections = num_sections;
   reload_data(self);
 }
@@ -266,7 +617,11 @@ static void simply_menu_add_section(SimplyMenu *self, SimplyMenuSection *section
     section->title = EMPTY_TITLE;
   }
   add_section(self, section);
-  reload_data(self);
+  if (set_section_info(self, section)) {
+    reload_data(self);
+  } else {
+    mark_dirty(self);
+  }
 }
 
 static void simply_menu_add_item(SimplyMenu *self, SimplyMenuItem *item) {
@@ -298,11 +653,21 @@ static void spinner_timer_callback(void *data) {
 }
 
 static SimplyMenuItem *get_first_request_item(SimplyMenu *self) {
-  return (SimplyMenuItem*) list1_find(self->menu_layer.items, request_item_filter, NULL);
+  for (List2Node *walk = self->menu_layer.items.lru.head; walk; walk = walk->next) {
+    if (((SimplyMenuItem*) walk)->title == NULL) {
+      return (SimplyMenuItem*) walk;
+    }
+  }
+  return NULL;
 }
 
 static SimplyMenuItem *get_last_request_item(SimplyMenu *self) {
-  return (SimplyMenuItem*) list1_find_last(self->menu_layer.items, request_item_filter, NULL);
+  for (List2Node *walk = self->menu_layer.items.lru.tail; walk; walk = walk->prev) {
+    if (((SimplyMenuItem*) walk)->title == NULL) {
+      return (SimplyMenuItem*) walk;
+    }
+  }
+  return NULL;
 }
 
 static void refresh_spinner_timer(SimplyMenu *self) {
@@ -318,12 +683,20 @@ static uint16_t menu_get_num_sections_callback(MenuLayer *menu_layer, void *data
 
 static uint16_t menu_get_num_rows_callback(MenuLayer *menu_layer, uint16_t section_index, void *data) {
   SimplyMenu *self = data;
+  SimplyMenuSectionInfo *info = get_section_info(self, section_index);
+  if (info) {
+    return info->num_items;
+  }
   SimplyMenuSection *section = get_menu_section(self, section_index);
   return section ? section->num_items : 1;
 }
 
 static int16_t menu_get_header_height_callback(MenuLayer *menu_layer, uint16_t section_index, void *data) {
   SimplyMenu *self = data;
+  SimplyMenuSectionInfo *info = get_section_info(self, section_index);
+  if (info) {
+    return info->has_title ? MENU_CELL_BASIC_HEADER_HEIGHT : 0;
+  }
   SimplyMenuSection *section = get_menu_section(self, section_index);
   return section && section->title && section->title != EMPTY_TITLE ? MENU_CELL_BASIC_HEADER_HEIGHT : 0;
 }
@@ -336,8 +709,11 @@ static void menu_draw_header_callback(GContext *ctx, const Layer *cell_layer, ui
     return;
   }
 
-  list1_remove(&self->menu_layer.sections, &section->node);
-  list1_prepend(&self->menu_layer.sections, &section->node);
+  cache_promote(&self->menu_layer.sections, &section->common);
+  if (!section->title) {
+    // The header is laid out from the section info while its title is still pending
+    return;
+  }
 
   GRect bounds = layer_get_bounds(cell_layer);
   bounds.origin.x += 2;
@@ -384,7 +760,7 @@ static void menu_draw_row_callback(GContext *ctx, const Layer *cell_layer, MenuI
 
   SimplyMenuItem *item = get_menu_item(self, cell_index->section, cell_index->row);
   if (!item) {
-    request_menu_item(self, cell_index->section, cell_index->row);
+    request_menu_items(self, cell_index->section, cell_index->row);
     return;
   }
 
@@ -397,8 +773,7 @@ static void menu_draw_row_callback(GContext *ctx, const Layer *cell_layer, MenuI
     return;
   }
 
-  list1_remove(&self->menu_layer.items, &item->node);
-  list1_prepend(&self->menu_layer.items, &item->node);
+  cache_promote(&self->menu_layer.items, &item->common);
 
   SimplyImage *image = simply_res_get_image(self->window.simply->res, item->icon);
   GColor8 *palette = NULL;
@@ -417,6 +792,15 @@ static void menu_draw_row_callback(GContext *ctx, const Layer *cell_layer, MenuI
   }
 }
 
+static void menu_selection_changed_callback(MenuLayer *menu_layer, MenuIndex new_index, MenuIndex old_index,
+                                            void *data) {
+  SimplyMenu *self = data;
+  const int comparison = menu_index_compare(&new_index, &old_index);
+  if (comparison) {
+    self->menu_layer.scroll_direction = comparison;
+  }
+}
+
 static void menu_select_click_callback(MenuLayer *menu_layer, MenuIndex *cell_index, void *data) {
   send_menu_select_click(cell_index->section, cell_index->row);
 }
@@ -458,6 +842,7 @@ static void window_load(Window *window) {
     .draw_row = menu_draw_row_callback,
     .select_click = menu_select_click_callback,
     .select_long_click = menu_select_long_click_callback,
+    .selection_changed = menu_selection_changed_callback,
   });
 
   menu_layer_set_click_config_provider_onto_window(menu_layer, click_config_provider, window);
@@ -471,7 +856,6 @@ static void window_appear(Window *window) {
 static void window_disappear(Window *window) {
   SimplyMenu *self = window_get_user_data(window);
   if (simply_window_disappear(&self->window)) {
-    simply_res_clear(self->window.simply->res);
     simply_menu_clear(self);
   }
 }
@@ -486,21 +870,27 @@ static void window_unload(Window *window) {
 }
 
 static void simply_menu_clear_section_items(SimplyMenu *self, int section_index) {
-  SimplyMenuItem *item = NULL;
-  do {
-    item = (SimplyMenuItem*) list1_find(self->menu_layer.items, section_filter, (void*)(uintptr_t) section_index);
-    destroy_item(self, item);
-  } while (item);
+  List2Node *walk = self->menu_layer.items.lru.head;
+  while (walk) {
+    SimplyMenuItem *item = (SimplyMenuItem*) walk;
+    walk = walk->next;
+    if (item->section == section_index) {
+      destroy_item(self, item);
+    }
+  }
 }
 
 static void simply_menu_clear(SimplyMenu *self) {
-  while (self->menu_layer.sections) {
-    destroy_section(self, (SimplyMenuSection*) self->menu_layer.sections);
+  while (self->menu_layer.sections.lru.head) {
+    destroy_section(self, (SimplyMenuSection*) self->menu_layer.sections.lru.head);
   }
 
-  while (self->menu_layer.items) {
-    destroy_item(self, (SimplyMenuItem*) self->menu_layer.items);
+  while (self->menu_layer.items.lru.head) {
+    destroy_item(self, (SimplyMenuItem*) self->menu_layer.items.lru.head);
   }
+  destroy_item_pool(self);
+
+  destroy_section_infos(self);
 
   reload_data(self);
 }
@@ -556,17 +946,98 @@ static void handle_menu_section_packet(Simply *simply, Packet *data) {
   simply_menu_add_section(simply->menu, section);
 }
 
+static SimplyMenuSection *create_section(uint16_t section_index, uint16_t num_items,
+                                         uint16_t title_length, const char *title) {
+  SimplyMenuSection *section = malloc(sizeof(*section));
+  if (!section) {
+    return NULL;
+  }
+  *section = (SimplyMenuSection) {
+    .section = section_index,
+    .num_items = num_items,
+    .title = title_length ? strdup2(title) : NULL,
+  };
+  if (section->title == NULL) {
+    section->title = EMPTY_TITLE;
+  }
+  return section;
+}
+
+//! Applies the metadata of many sections with a single reload. All row counts are kept in the section
+//! info table while the titles go through the section cache, keeping the first sections cached.
+static void handle_menu_sections_packet(Simply *simply, Packet *data) {
+  MenuSectionsPacket *packet = (MenuSectionsPacket*) data;
+  SimplyMenu *self = simply->menu;
+  const uint16_t num_records = MIN(packet->num_sections, self->menu_layer.num_sections);
+  if (!self->menu_layer.section_infos) {
+    self->menu_layer.section_infos = malloc0(self->menu_layer.num_sections * sizeof(SimplyMenuSectionInfo));
+  }
+
+  const uint8_t *end = (uint8_t*) data + data->length;
+  const uint8_t *cursor = packet->records;
+  MenuSectionRecord *records[MAX_CACHED_SECTIONS];
+  uint16_t num_cached = 0;
+  for (uint16_t i = 0; i < num_records && cursor + sizeof(MenuSectionRecord) <= end; i++) {
+    MenuSectionRecord *record = (MenuSectionRecord*) cursor;
+    cursor = (uint8_t*) record->title + record->title_length + 1;
+    if (cursor > end) {
+      break;
+    }
+    if (self->menu_layer.section_infos) {
+      self->menu_layer.section_infos[i] = (SimplyMenuSectionInfo) {
+        .num_items = record->num_items,
+        .has_title = (record->title_length > 0),
+        .is_known = true,
+      };
+    }
+    if (num_cached < MIN(ARRAY_LENGTH(records), self->menu_layer.sections.capacity)) {
+      records[num_cached++] = record;
+    }
+  }
+
+  // Insert in reverse so that the first sections end up the most recently used
+  while (num_cached--) {
+    MenuSectionRecord *record = records[num_cached];
+    SimplyMenuSection *section = create_section(num_cached, record->num_items, record->title_length,
+                                                record->title);
+    if (section) {
+      add_section(self, section);
+    }
+  }
+
+  reload_data(self);
+}
+
 static void handle_menu_item_packet(Simply *simply, Packet *data) {
   MenuItemPacket *packet = (MenuItemPacket*) data;
-  SimplyMenuItem *item = malloc(sizeof(*item));
-  *item = (SimplyMenuItem) {
-    .section = packet->section,
-    .item = packet->item,
-    .title = packet->title_length ? strdup2(packet->buffer) : NULL,
-    .subtitle = packet->subtitle_length ? strdup2(packet->buffer + packet->title_length + 1) : NULL,
-    .icon = packet->icon,
-  };
-  simply_menu_add_item(simply->menu, item);
+  SimplyMenuItem *item = create_item(simply->menu, packet->section, packet->item, packet->icon,
+                                     packet->title_length ? packet->buffer : NULL,
+                                     packet->subtitle_length ? packet->buffer + packet->title_length + 1 : NULL);
+  if (item) {
+    simply_menu_add_item(simply->menu, item);
+  }
+}
+
+static void handle_menu_items_packet(Simply *simply, Packet *data) {
+  MenuItemsPacket *packet = (MenuItemsPacket*) data;
+  const uint8_t *end = (uint8_t*) data + data->length;
+  const uint8_t *cursor = packet->records;
+  for (uint16_t i = 0; i < packet->num_items && cursor + sizeof(MenuItemRecord) <= end; i++) {
+    MenuItemRecord *record = (MenuItemRecord*) cursor;
+    const char *title = record->buffer;
+    const char *subtitle = title + record->title_length + 1;
+    cursor = (uint8_t*) subtitle + record->subtitle_length + 1;
+    if (cursor > end) {
+      break;
+    }
+    SimplyMenuItem *item = create_item(simply->menu, packet->section, record->item, record->icon,
+                                       record->title_length ? title : NULL,
+                                       record->subtitle_length ? subtitle : NULL);
+    if (!item) {
+      break;
+    }
+    simply_menu_add_item(simply->menu, item);
+  }
 }
 
 static void handle_menu_get_selection_packet(Simply *simply, Packet *data) {
@@ -599,6 +1070,12 @@ bool simply_menu_handle_packet(Simply *simply, Packet *packet) {
     case CommandMenuItem:
       handle_menu_item_packet(simply, packet);
       return true;
+    case CommandMenuItems:
+      handle_menu_items_packet(simply, packet);
+      return true;
+    case CommandMenuSections:
+      handle_menu_sections_packet(simply, packet);
+      return true;
     case CommandMenuSelection:
       handle_menu_selection_packet(simply, packet);
       return true;
@@ -614,6 +1091,7 @@ SimplyMenu *simply_menu_create(Simply *simply) {
   *self = (SimplyMenu) {
     .window.simply = simply,
     .menu_layer.num_sections = 1,
+    .menu_layer.scroll_direction = 1,
   };
 
   static const WindowHandlers s_window_handlers = {
@@ -624,6 +1102,11 @@ SimplyMenu *simply_menu_create(Simply *simply) {
   };
   self->window.window_handlers = &s_window_handlers;
 
+  cache_init(&self->menu_layer.sections, self->menu_layer.section_buckets, SIMPLY_MENU_SECTION_BUCKETS,
+             INITIAL_CACHED_SECTIONS, MIN_CACHED_SECTIONS, MAX_CACHED_SECTIONS);
+  cache_init(&self->menu_layer.items, self->menu_layer.item_buckets, SIMPLY_MENU_ITEM_BUCKETS,
+             INITIAL_CACHED_ITEMS, MIN_CACHED_ITEMS, MAX_CACHED_ITEMS);
+
   simply_window_init(&self->window, simply);
   simply_window_set_background_color(&self->window, GColor8White);
 
@@ -635,6 +1118,8 @@ void simply_menu_destroy(SimplyMenu *self) {
     return;
   }
 
+  destroy_section_infos(self);
+
   simply_window_deinit(&self->window);
 
   free(self);
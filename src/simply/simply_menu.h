@@ -7,6 +7,8 @@
 #include "simply.h"
 
 #include "util/list1.h"
+#include "util/list2.h"
+#include "util/platform.h"
 
 #include <pebble.h>
 
@@ -18,13 +20,64 @@ enum SimplyMenuType {
   SimplyMenuTypeItem,
 };
 
+//! Hash bucket counts, powers of two that keep chains short up to the largest cache capacities
+#define SIMPLY_MENU_SECTION_BUCKETS 16
+#define SIMPLY_MENU_ITEM_BUCKETS IF_APLITE_ELSE(16, 64)
+
+typedef struct SimplyMenuCommon SimplyMenuCommon;
+
+typedef struct SimplyMenuCache SimplyMenuCache;
+
+//! LRU list of sections or items with the most recently used first, indexed by a chained hash table.
+//! Lookup, promotion and eviction are constant time.
+struct SimplyMenuCache {
+  List2 lru;
+  SimplyMenuCommon **buckets;
+  uint16_t num_buckets;
+  uint16_t size;
+  uint16_t capacity;
+  uint16_t min_capacity;
+  uint16_t max_capacity;
+};
+
+typedef struct SimplyMenuSectionInfo SimplyMenuSectionInfo;
+
+//! Row count and header presence of a section, known without having its title cached
+struct SimplyMenuSectionInfo {
+  uint16_t num_items;
+  bool has_title;
+  bool is_known;
+};
+
+typedef struct SimplyMenuArena SimplyMenuArena;
+
+//! Bump allocated text of the cached items of one section. It is freed once none of them remain,
+//! and compacted into a new arena when it runs out of room.
+struct SimplyMenuArena {
+  List1Node node;
+  uint16_t section;
+  uint16_t num_items;
+  uint16_t size;
+  uint16_t used;
+  uint16_t live;
+  char buffer[];
+};
+
 typedef struct SimplyMenuLayer SimplyMenuLayer;
 
 struct SimplyMenuLayer {
   MenuLayer *menu_layer;
-  List1Node *sections;
-  List1Node *items;
+  SimplyMenuCache sections;
+  SimplyMenuCache items;
+  SimplyMenuSectionInfo *section_infos;
+  List1Node *item_arenas;
+  List1Node *item_slabs;
+  SimplyMenuCommon *free_items;
+  uint16_t num_evictions;
+  SimplyMenuCommon *section_buckets[SIMPLY_MENU_SECTION_BUCKETS];
+  SimplyMenuCommon *item_buckets[SIMPLY_MENU_ITEM_BUCKETS];
   uint16_t num_sections;
+  int8_t scroll_direction;
   GColor8 normal_foreground;
   GColor8 normal_background;
   GColor8 highlight_foreground;
@@ -39,10 +92,10 @@ struct SimplyMenu {
   AppTimer *spinner_timer;
 };
 
-typedef struct SimplyMenuCommon SimplyMenuCommon;
-
 struct SimplyMenuCommon {
-  List1Node node;
+  List2Node node;
+  SimplyMenuCommon *bucket_next;
+  uint32_t key;
   uint16_t section;
   char *title;
 };
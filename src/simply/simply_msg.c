@@ -1,6 +1,8 @@
 #include "simply_msg.h"
 
 #include "simply_accel.h"
+#include "simply_batch.h"
+#include "simply_image_store.h"
 #include "simply_voice.h"
 #include "simply_res.h"
 #include "simply_stage.h"
@@ -54,12 +56,54 @@ typedef struct ImagePacket ImagePacket;
 struct __attribute__((__packed__)) ImagePacket {
   Packet packet;
   uint32_t id;
+  //! Content hash of the pixels computed by JS, or 0 if the image should not be stored
+  uint32_t hash;
+  SimplyImageFormat format:8;
   int16_t width;
   int16_t height;
   uint16_t pixels_length;
   uint8_t pixels[];
 };
 
+typedef struct ImageSpritePacket ImageSpritePacket;
+
+struct __attribute__((__packed__)) ImageSpritePacket {
+  Packet packet;
+  uint32_t id;
+  uint32_t atlas;
+  GRect source;
+};
+
+typedef struct ImageFormatsPacket ImageFormatsPacket;
+
+struct __attribute__((__packed__)) ImageFormatsPacket {
+  Packet packet;
+  uint32_t formats;
+};
+
+typedef struct ImageHashPacket ImageHashPacket;
+
+struct __attribute__((__packed__)) ImageHashPacket {
+  Packet packet;
+  uint32_t id;
+  uint32_t hash;
+};
+
+typedef struct ImageStoreHashesPacket ImageStoreHashesPacket;
+
+struct __attribute__((__packed__)) ImageStoreHashesPacket {
+  Packet packet;
+  uint8_t num_hashes;
+  uint32_t hashes[IMAGE_STORE_MAX_ENTRIES];
+};
+
+typedef struct ImageBudgetPacket ImageBudgetPacket;
+
+struct __attribute__((__packed__)) ImageBudgetPacket {
+  Packet packet;
+  uint32_t budget;
+};
+
 typedef struct VibePacket VibePacket;
 
 struct __attribute__((__packed__)) VibePacket {
@@ -155,8 +199,65 @@ static void handle_segment_packet(Simply *simply, Packet *data) {
 
 static void handle_image_packet(Simply *simply, Packet *data) {
   ImagePacket *packet = (ImagePacket*) data;
-  simply_res_add_image(simply->res, packet->id, packet->width, packet->height, packet->pixels,
-                       packet->pixels_length);
+  SimplyImage *image = simply_res_add_image(simply->res, packet->id, packet->format, packet->width,
+                                            packet->height, packet->pixels, packet->pixels_length);
+  if (image && packet->hash) {
+    simply_image_store_save(packet->hash, packet->format, packet->width, packet->height, packet->pixels,
+                            packet->pixels_length);
+  }
+}
+
+static void send_image_formats(void) {
+  ImageFormatsPacket packet = {
+    .packet.type = CommandImageFormats,
+    .packet.length = sizeof(packet),
+    .formats = simply_res_get_image_formats(),
+  };
+  simply_msg_send_packet(&packet.packet);
+}
+
+static void send_image_store_hashes(void) {
+  uint32_t hashes[IMAGE_STORE_MAX_ENTRIES];
+  const size_t num_hashes = simply_image_store_get_hashes(hashes, ARRAY_LENGTH(hashes));
+  ImageStoreHashesPacket packet = {
+    .packet.type = CommandImageStoreHashes,
+    .packet.length = sizeof(packet) - sizeof(packet.hashes) + num_hashes * sizeof(hashes[0]),
+    .num_hashes = num_hashes,
+  };
+  memcpy(packet.hashes, hashes, num_hashes * sizeof(hashes[0]));
+  simply_msg_send_packet(&packet.packet);
+}
+
+static void handle_image_bind_packet(Simply *simply, Packet *data) {
+  ImageHashPacket *packet = (ImageHashPacket*) data;
+  SimplyImageStoreEntry entry;
+  uint8_t *pixels = simply_image_store_load(packet->hash, &entry);
+  SimplyImage *image = NULL;
+  if (pixels) {
+    image = simply_res_add_image(simply->res, packet->id, entry.format, entry.width, entry.height, pixels,
+                                 entry.length);
+    free(pixels);
+  }
+  if (!image) {
+    // Ask JS to transfer the image after all
+    ImageHashPacket miss = {
+      .packet.type = CommandImageMiss,
+      .packet.length = sizeof(miss),
+      .id = packet->id,
+      .hash = packet->hash,
+    };
+    simply_msg_send_packet(&miss.packet);
+  }
+}
+
+static void handle_image_sprite_packet(Simply *simply, Packet *data) {
+  ImageSpritePacket *packet = (ImageSpritePacket*) data;
+  simply_res_add_sprite(simply->res, packet->id, packet->atlas, packet->source);
+}
+
+static void handle_image_budget_packet(Simply *simply, Packet *data) {
+  ImageBudgetPacket *packet = (ImageBudgetPacket*) data;
+  simply_res_set_image_budget(simply->res, packet->budget);
 }
 
 static void handle_vibe_packet(Simply *simply, Packet *data) {
@@ -179,12 +280,25 @@ static void handle_light_packet(Simply *simply, Packet *data) {
 
 static bool simply_base_handle_packet(Simply *simply, Packet *packet) {
   switch (packet->type) {
+    case CommandReady:
+      send_image_formats();
+      send_image_store_hashes();
+      return false;
     case CommandSegment:
       handle_segment_packet(simply, packet);
       return true;
     case CommandImagePacket:
       handle_image_packet(simply, packet);
       return true;
+    case CommandImageSprite:
+      handle_image_sprite_packet(simply, packet);
+      return true;
+    case CommandImageBudget:
+      handle_image_budget_packet(simply, packet);
+      return true;
+    case CommandImageBind:
+      handle_image_bind_packet(simply, packet);
+      return true;
     case CommandVibe:
       handle_vibe_packet(simply, packet);
       return true;
@@ -197,6 +311,7 @@ static bool simply_base_handle_packet(Simply *simply, Packet *packet) {
 
 static void handle_packet(Simply *simply, Packet *packet) {
   if (simply_base_handle_packet(simply, packet)) { return; }
+  if (simply_batch_handle_packet(simply, packet)) { return; }
   if (simply_wakeup_handle_packet(simply, packet)) { return; }
   if (simply_window_stack_handle_packet(simply, packet)) { return; }
   if (simply_window_handle_packet(simply, packet)) { return; }
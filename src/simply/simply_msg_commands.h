@@ -55,5 +55,24 @@ enum Command {
   CommandVoiceStart,
   CommandVoiceStop,
   CommandVoiceData,
+  CommandElementDefine,
+  CommandCardDefine,
+  CommandBatchBegin,
+  CommandBatchCommit,
+  CommandElementPath,
+  CommandElementPathAppend,
+  CommandElementChart,
+  CommandElementChartAppend,
+  CommandImageSprite,
+  CommandElementMove,
+  CommandMenuGetItemRange,
+  CommandMenuItems,
+  CommandMenuSections,
+  CommandImageBudget,
+  CommandImageBind,
+  CommandImageMiss,
+  CommandImageStoreHashes,
+  CommandImageEvicted,
+  CommandImageFormats,
   NumCommands,
 };
@@ -1,15 +1,86 @@
 #include "simply_res.h"
 
+#include "simply_msg.h"
+
 #include "util/color.h"
 #include "util/graphics.h"
 #include "util/memory.h"
+#include "util/platform.h"
 #include "util/sdk.h"
 #include "util/window.h"
 
 #include <pebble.h>
 
-static bool id_filter(List1Node *node, void *data) {
-  return (((SimplyResItemCommon*) node)->id == (uint32_t)(uintptr_t) data);
+#define DEFAULT_IMAGES_BUDGET IF_APLITE_ELSE(6144, 32768)
+
+typedef struct ImageEvictedPacket ImageEvictedPacket;
+
+struct __attribute__((__packed__)) ImageEvictedPacket {
+  Packet packet;
+  uint32_t id;
+};
+
+#define IMAGE_INDEX(self) &(self)->images, (self)->image_buckets, ARRAY_LENGTH((self)->image_buckets)
+#define FONT_INDEX(self) &(self)->fonts, (self)->font_buckets, ARRAY_LENGTH((self)->font_buckets)
+#define PIN_INDEX(self) &(self)->image_pins, (self)->pin_buckets, ARRAY_LENGTH((self)->pin_buckets)
+
+static SimplyResItemCommon **index_bucket(SimplyResItemCommon **buckets, size_t num_buckets, uint32_t id) {
+  // Fibonacci hashing spreads the consecutive ids that JS hands out across the buckets
+  return &buckets[((id * 2654435761u) >> 16) & (num_buckets - 1)];
+}
+
+static SimplyResItemCommon *index_find(List1Node **list, SimplyResItemCommon **buckets, size_t num_buckets,
+                                       uint32_t id) {
+  for (SimplyResItemCommon *walk = *index_bucket(buckets, num_buckets, id); walk; walk = walk->bucket_next) {
+    if (walk->id == id) {
+      return walk;
+    }
+  }
+  return NULL;
+}
+
+static void index_link(List1Node **list, SimplyResItemCommon **buckets, size_t num_buckets,
+                       SimplyResItemCommon *item) {
+  SimplyResItemCommon **bucket = index_bucket(buckets, num_buckets, item->id);
+  item->bucket_next = *bucket;
+  *bucket = item;
+  list1_prepend(list, &item->node);
+}
+
+static void index_unlink(List1Node **list, SimplyResItemCommon **buckets, size_t num_buckets,
+                         SimplyResItemCommon *item) {
+  list1_remove(list, &item->node);
+  for (SimplyResItemCommon **ref = index_bucket(buckets, num_buckets, item->id); *ref;
+       ref = &(*ref)->bucket_next) {
+    if (*ref == item) {
+      *ref = item->bucket_next;
+      break;
+    }
+  }
+  item->bucket_next = NULL;
+}
+
+static SimplyImage *find_image(SimplyRes *self, uint32_t id) {
+  return (SimplyImage*) index_find(IMAGE_INDEX(self), id);
+}
+
+static SimplyImagePin *find_pin(SimplyRes *self, uint32_t id) {
+  return (SimplyImagePin*) index_find(PIN_INDEX(self), id);
+}
+
+static bool atlas_filter(List1Node *node, void *data) {
+  return (((SimplyImage*) node)->atlas_id == (uint32_t)(uintptr_t) data);
+}
+
+//! Updates the count of pinned sprites kept on the atlas of a sprite whose pin changed
+static void count_atlas_pin(SimplyRes *self, SimplyImage *sprite, int delta) {
+  if (!sprite || !sprite->atlas_id) {
+    return;
+  }
+  SimplyImage *atlas = find_image(self, sprite->atlas_id);
+  if (atlas) {
+    atlas->num_pinned_sprites += delta;
+  }
 }
 
 static void destroy_image(SimplyRes *self, SimplyImage *image) {
@@ -17,10 +88,27 @@ static void destroy_image(SimplyRes *self, SimplyImage *image) {
     return;
   }
 
-  list1_remove(&self->images, &image->node);
-  gbitmap_destroy(image->bitmap);
+  index_unlink(IMAGE_INDEX(self), &image->common);
+  self->images_size -= image->size;
+
+  if (find_pin(self, image->id)) {
+    count_atlas_pin(self, image, -1);
+  }
+
+  if (!image->atlas_id) {
+    SimplyImage *sprite;
+    while ((sprite = (SimplyImage*) list1_find(self->images, atlas_filter, (void*)(uintptr_t) image->id))) {
+      destroy_image(self, sprite);
+    }
+  }
+
+  if (image->bitmap) {
+    gbitmap_destroy(image->bitmap);
+  }
   free(image->palette);
   free(image);
+
+  ++self->images_version;
 }
 
 static void destroy_font(SimplyRes *self, SimplyFont *font) {
@@ -28,7 +116,7 @@ static void destroy_font(SimplyRes *self, SimplyFont *font) {
     return;
   }
 
-  list1_remove(&self->fonts, &font->node);
+  index_unlink(FONT_INDEX(self), &font->common);
   fonts_unload_custom_font(font->font);
   free(font);
 }
@@ -36,7 +124,8 @@ static void destroy_font(SimplyRes *self, SimplyFont *font) {
 static void setup_image(SimplyImage *image) {
   image->is_palette_black_and_white = gbitmap_is_palette_black_and_white(image->bitmap);
 
-  if (!image->is_palette_black_and_white) {
+  // Raw palettized images already own their palette
+  if (!image->is_palette_black_and_white || image->palette) {
     return;
   }
 
@@ -47,20 +136,174 @@ static void setup_image(SimplyImage *image) {
   image->palette = palette_copy;
 }
 
+static uint32_t image_size(SimplyImage *image) {
+  uint32_t size = sizeof(*image) + image->png_data_length;
+  if (image->bitmap && !image->atlas_id) {
+    const GRect bounds = gbitmap_get_bounds(image->bitmap);
+    size += gbitmap_get_bytes_per_row(image->bitmap) * bounds.size.h;
+  }
+  return size;
+}
+
+static void update_image_size(SimplyRes *self, SimplyImage *image) {
+  self->images_size -= image->size;
+  image->size = image_size(image);
+  self->images_size += image->size;
+}
+
+static bool is_image_pinned(SimplyRes *self, SimplyImage *image) {
+  return (image->num_pinned_sprites || find_pin(self, image->id));
+}
+
+//! Finds the least recently drawn image that is not pinned, or only among the images with a decoded
+//! bitmap that can be dropped in favor of their compressed data. Sprites are left to their atlas
+//! since they do not hold any pixels of their own.
+static SimplyImage *find_evictable_image(SimplyRes *self, SimplyImage *except, bool is_decoded_only) {
+  SimplyImage *victim = NULL;
+  for (List1Node *walk = self->images; walk; walk = walk->next) {
+    SimplyImage *image = (SimplyImage*) walk;
+    if (image == except || image->atlas_id || (is_decoded_only && !(image->png_data && image->bitmap)) ||
+        is_image_pinned(self, image)) {
+      continue;
+    }
+    // Images are prepended, so on a tie the one further down the list is older
+    if (!victim || (int32_t)(image->drawn_at - victim->drawn_at) <= 0) {
+      victim = image;
+    }
+  }
+  return victim;
+}
+
+static bool send_image_evicted(uint32_t id) {
+  ImageEvictedPacket packet = {
+    .packet.type = CommandImageEvicted,
+    .packet.length = sizeof(packet),
+    .id = id,
+  };
+  return simply_msg_send_packet(&packet.packet);
+}
+
+//! Destroys an image that JS still considers loaded and tells JS so that it is uploaded again when
+//! needed. Bundled images are reloaded by the watch itself.
+static void evict_image(SimplyRes *self, SimplyImage *image) {
+  const uint32_t id = image->id;
+  destroy_image(self, image);
+  if (id > self->num_bundled_res) {
+    send_image_evicted(id);
+  }
+}
+
+static bool unused_font_filter(List1Node *node, void *data) {
+  return (((SimplyFont*) node)->count == 0);
+}
+
+//! Frees the decoded bitmap of an image that keeps its compressed data, and the sub-bitmaps of its
+//! sprites, which are created again when drawn
+static void drop_decoded_image(SimplyRes *self, SimplyImage *image) {
+  for (List1Node *walk = self->images; walk; walk = walk->next) {
+    SimplyImage *sprite = (SimplyImage*) walk;
+    if (sprite->atlas_id == image->id && sprite->bitmap) {
+      gbitmap_destroy(sprite->bitmap);
+      sprite->bitmap = NULL;
+    }
+  }
+  gbitmap_destroy(image->bitmap);
+  image->bitmap = NULL;
+  free(image->palette);
+  image->palette = NULL;
+  update_image_size(self, image);
+}
+
+//! Frees memory after an allocation failed, preferring decoded bitmaps over compressed data.
+//! Unused fonts are unloaded once no image can be evicted.
+static bool free_memory(SimplyRes *self, SimplyImage *except) {
+  SimplyImage *image;
+  if ((image = find_evictable_image(self, except, true))) {
+    drop_decoded_image(self, image);
+  } else if ((image = find_evictable_image(self, except, false))) {
+    evict_image(self, image);
+  } else {
+    SimplyFont *font = (SimplyFont*) list1_find(self->fonts, unused_font_filter, NULL);
+    if (!font) {
+      return false;
+    }
+    destroy_font(self, font);
+  }
+  ++self->num_evictions;
+  return true;
+}
+
 bool simply_res_evict_image(SimplyRes *self) {
-  SimplyImage *last_image = (SimplyImage *)list1_last(self->images);
-  if (!last_image) {
+  return free_memory(self, NULL);
+}
+
+static void trim_images(SimplyRes *self, SimplyImage *except) {
+  SimplyImage *image;
+  while (self->images_size > self->images_budget) {
+    if ((image = find_evictable_image(self, except, true))) {
+      drop_decoded_image(self, image);
+    } else if ((image = find_evictable_image(self, except, false))) {
+      evict_image(self, image);
+    } else {
+      break;
+    }
+  }
+}
+
+void simply_res_set_image_budget(SimplyRes *self, size_t budget) {
+  self->images_budget = budget ? budget : DEFAULT_IMAGES_BUDGET;
+  trim_images(self, NULL);
+}
+
+static void account_image(SimplyRes *self, SimplyImage *image) {
+  image->drawn_at = ++self->images_clock;
+  update_image_size(self, image);
+}
+
+//! Creates the bitmap of an image that only holds compressed data, or of a sprite of such an atlas
+static bool decode_image(SimplyRes *self, SimplyImage *image) {
+  if (image->bitmap) {
+    return true;
+  }
+
+  if (image->atlas_id) {
+    SimplyImage *atlas = find_image(self, image->atlas_id);
+    if (!atlas || !decode_image(self, atlas)) {
+      return false;
+    }
+    image->bitmap = gbitmap_create_as_sub_bitmap(atlas->bitmap, image->source);
+    // The sub-bitmap shares the atlas palette, which outlives the sprite
+    image->is_palette_black_and_white = atlas->is_palette_black_and_white;
+    return (image->bitmap != NULL);
+  }
+
+  if (!image->png_data) {
     return false;
   }
 
-  destroy_image(self, last_image);
+  GBitmap *bitmap = NULL;
+  while (!(bitmap = gbitmap_create_from_png_data(image->png_data, image->png_data_length))) {
+    if (!free_memory(self, image)) {
+      return false;
+    }
+  }
+
+  image->bitmap = bitmap;
+  setup_image(image);
+  update_image_size(self, image);
+  trim_images(self, image);
   return true;
 }
 
 static void add_image(SimplyRes *self, SimplyImage *image) {
-  list1_prepend(&self->images, &image->node);
+  index_link(IMAGE_INDEX(self), &image->common);
+  ++self->images_version;
 
-  setup_image(image);
+  if (image->bitmap) {
+    setup_image(image);
+  }
+  account_image(self, image);
+  trim_images(self, image);
 
   window_stack_schedule_top_window_render();
 }
@@ -109,26 +352,108 @@ typedef struct {
   GSize size;
   size_t data_length;
   const uint8_t *data;
+  GBitmapFormat bitmap_format;
+  uint8_t bits_per_pixel;
+  uint16_t num_colors;
+  uint16_t row_size;
 } CreateDataContext;
 
-SDK_2_USAGE static GBitmap *create_bitmap_with_data(SimplyImage *image, void *data) {
+//! Fills in the bitmap layout of a raw format, returning false if the format is not supported
+static bool get_raw_format(SimplyImageFormat format, CreateDataContext *ctx) {
+  switch (format) {
+    case SimplyImageFormatRaw1Bit:
+      ctx->bitmap_format = GBitmapFormat1Bit;
+      ctx->bits_per_pixel = 1;
+      // 1-bit rows are word aligned
+      ctx->row_size = (ctx->size.w + 31) / 32 * 4;
+      return true;
+#ifdef PBL_SDK_3
+    case SimplyImageFormatRaw1BitPalette:
+      ctx->bitmap_format = GBitmapFormat1BitPalette;
+      ctx->bits_per_pixel = 1;
+      break;
+    case SimplyImageFormatRaw2BitPalette:
+      ctx->bitmap_format = GBitmapFormat2BitPalette;
+      ctx->bits_per_pixel = 2;
+      break;
+    case SimplyImageFormatRaw4BitPalette:
+      ctx->bitmap_format = GBitmapFormat4BitPalette;
+      ctx->bits_per_pixel = 4;
+      break;
+#endif
+    default:
+      return false;
+  }
+  ctx->num_colors = 1 << ctx->bits_per_pixel;
+  ctx->row_size = (ctx->size.w * ctx->bits_per_pixel + 7) / 8;
+  return true;
+}
+
+static GBitmap *create_bitmap_with_data(SimplyImage *image, void *data) {
   CreateDataContext *ctx = data;
-  GBitmap *bitmap = gbitmap_create_blank(ctx->size, GBitmapFormat1Bit);
-  if (bitmap) {
-    image->bitmap_data = gbitmap_get_data(bitmap);
-    memcpy(image->bitmap_data, ctx->data, ctx->data_length);
+  GColor8 *palette = NULL;
+  GBitmap *bitmap = NULL;
+  if (ctx->num_colors) {
+    if (!(palette = malloc(ctx->num_colors * sizeof(*palette)))) {
+      return NULL;
+    }
+    memcpy(palette, ctx->data, ctx->num_colors * sizeof(*palette));
+    bitmap = gbitmap_create_blank_with_palette(ctx->size, ctx->bitmap_format, palette, false);
+  } else {
+    bitmap = gbitmap_create_blank(ctx->size, ctx->bitmap_format);
+  }
+  if (!bitmap) {
+    free(palette);
+    return NULL;
+  }
+
+  image->palette = palette;
+  image->bitmap_data = gbitmap_get_data(bitmap);
+  const uint8_t *src = ctx->data + ctx->num_colors * sizeof(*palette);
+  const uint16_t dst_row_size = gbitmap_get_bytes_per_row(bitmap);
+  for (int16_t y = 0; y < ctx->size.h; ++y) {
+    memcpy(image->bitmap_data + y * dst_row_size, src + y * ctx->row_size, ctx->row_size);
   }
   return bitmap;
 }
 
-SDK_3_USAGE static GBitmap *create_bitmap_with_png_data(SimplyImage *image, void *data) {
-  CreateDataContext *ctx = data;
-  return ctx->data ? gbitmap_create_from_png_data(ctx->data, ctx->data_length) : NULL;
+static const uint8_t PNG_SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+//! Keeps a copy of PNG data in the same allocation as the image without decoding it
+SDK_3_USAGE static SimplyImage *create_png_image(SimplyRes *self, CreateDataContext *ctx) {
+  if (!ctx->data || ctx->data_length < sizeof(PNG_SIGNATURE) ||
+      memcmp(ctx->data, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0) {
+    return NULL;
+  }
+
+  SimplyImage *image = NULL;
+  while (!(image = malloc0(sizeof(*image) + ctx->data_length))) {
+    if (!simply_res_evict_image(self)) {
+      return NULL;
+    }
+  }
+
+  image->png_data = (uint8_t*) (image + 1);
+  image->png_data_length = ctx->data_length;
+  memcpy(image->png_data, ctx->data, ctx->data_length);
+  return image;
 }
 
-SimplyImage *simply_res_add_image(SimplyRes *self, uint32_t id, int16_t width, int16_t height,
-                                  uint8_t *pixels, uint16_t pixels_length) {
-  SimplyImage *image = (SimplyImage*) list1_find(self->images, id_filter, (void*)(uintptr_t) id);
+uint32_t simply_res_get_image_formats(void) {
+  uint32_t formats = (1 << SimplyImageFormatRaw1Bit);
+#ifdef PBL_SDK_3
+  formats |= (1 << SimplyImageFormatPng);
+#endif
+#ifdef PBL_COLOR
+  formats |= (1 << SimplyImageFormatRaw1BitPalette) | (1 << SimplyImageFormatRaw2BitPalette) |
+             (1 << SimplyImageFormatRaw4BitPalette);
+#endif
+  return formats;
+}
+
+SimplyImage *simply_res_add_image(SimplyRes *self, uint32_t id, SimplyImageFormat format, int16_t width,
+                                  int16_t height, uint8_t *pixels, uint16_t pixels_length) {
+  SimplyImage *image = find_image(self, id);
   if (image) {
     destroy_image(self, image);
   }
@@ -138,8 +463,14 @@ SimplyImage *simply_res_add_image(SimplyRes *self, uint32_t id, int16_t width, i
     .data_length = pixels_length,
     .data = pixels,
   };
-  image = IF_SDK_3_ELSE(create_image(self, create_bitmap_with_png_data, &context),
-                        create_image(self, create_bitmap_with_data, &context));
+  if (format == SimplyImageFormatPng) {
+    image = IF_SDK_3_ELSE(create_png_image(self, &context), NULL);
+  } else if (get_raw_format(format, &context) && width >= 0 && height >= 0 &&
+             pixels_length == context.num_colors * sizeof(GColor8) + context.row_size * height) {
+    image = create_image(self, create_bitmap_with_data, &context);
+  } else {
+    image = NULL;
+  }
   if (image) {
     image->id = id;
     add_image(self, image);
@@ -147,8 +478,40 @@ SimplyImage *simply_res_add_image(SimplyRes *self, uint32_t id, int16_t width, i
   return image;
 }
 
+SimplyImage *simply_res_add_sprite(SimplyRes *self, uint32_t id, uint32_t atlas_id, GRect source) {
+  SimplyImage *image = find_image(self, id);
+  if (image) {
+    destroy_image(self, image);
+  }
+
+  SimplyImage *atlas = find_image(self, atlas_id);
+  if (!atlas || !(atlas->bitmap || atlas->png_data) || atlas->atlas_id) {
+    return NULL;
+  }
+
+  image = malloc0(sizeof(*image));
+  if (!image) {
+    return NULL;
+  }
+
+  // The sub-bitmap is created when the sprite is first drawn
+  image->id = id;
+  image->atlas_id = atlas_id;
+  image->source = source;
+  index_link(IMAGE_INDEX(self), &image->common);
+  if (find_pin(self, id)) {
+    count_atlas_pin(self, image, 1);
+  }
+  ++self->images_version;
+  account_image(self, image);
+
+  window_stack_schedule_top_window_render();
+
+  return image;
+}
+
 void simply_res_remove_image(SimplyRes *self, uint32_t id) {
-  SimplyImage *image = (SimplyImage*) list1_find(self->images, id_filter, (void*)(uintptr_t) id);
+  SimplyImage *image = find_image(self, id);
   if (image) {
     destroy_image(self, image);
   }
@@ -158,72 +521,163 @@ SimplyImage *simply_res_auto_image(SimplyRes *self, uint32_t id, bool is_placeho
   if (!id) {
     return NULL;
   }
-  SimplyImage *image = (SimplyImage*) list1_find(self->images, id_filter, (void*)(uintptr_t) id);
+  SimplyImage *image = find_image(self, id);
   if (image) {
-    return image;
+    image->drawn_at = ++self->images_clock;
+    if (image->atlas_id) {
+      SimplyImage *atlas = find_image(self, image->atlas_id);
+      if (atlas) {
+        atlas->drawn_at = image->drawn_at;
+      }
+    }
+    return decode_image(self, image) ? image : NULL;
   }
   if (id <= self->num_bundled_res) {
     return simply_res_add_bundled_image(self, id);
   }
   if (is_placeholder) {
-    return simply_res_add_image(self, id, 0, 0, NULL, 0);
+    return simply_res_add_image(self, id, IF_SDK_3_ELSE(SimplyImageFormatPng, SimplyImageFormatRaw1Bit),
+                                0, 0, NULL, 0);
   }
   return NULL;
 }
 
-GFont simply_res_add_custom_font(SimplyRes *self, uint32_t id) {
-  SimplyFont *font = malloc(sizeof(*font));
-  if (!font) {
-    return NULL;
+void simply_res_pin_image(SimplyRes *self, uint32_t id) {
+  if (!id) {
+    return;
   }
+  SimplyImagePin *pin = find_pin(self, id);
+  if (!pin) {
+    if (!(pin = malloc0(sizeof(*pin)))) {
+      return;
+    }
+    pin->id = id;
+    index_link(PIN_INDEX(self), &pin->common);
+    count_atlas_pin(self, find_image(self, id), 1);
+  }
+  ++pin->count;
+}
 
+void simply_res_unpin_image(SimplyRes *self, uint32_t id) {
+  if (!id) {
+    return;
+  }
+  SimplyImagePin *pin = find_pin(self, id);
+  if (pin && --pin->count == 0) {
+    index_unlink(PIN_INDEX(self), &pin->common);
+    free(pin);
+    count_atlas_pin(self, find_image(self, id), -1);
+  }
+}
+
+//! Moves the pin held by a reference to an image from the id it holds to a new id
+void simply_res_set_image_pin(SimplyRes *self, uint32_t *pinned_id, uint32_t id) {
+  if (*pinned_id == id) {
+    return;
+  }
+  simply_res_pin_image(self, id);
+  simply_res_unpin_image(self, *pinned_id);
+  *pinned_id = id;
+}
+
+static SimplyFont *add_custom_font(SimplyRes *self, uint32_t id) {
   ResHandle handle = resource_get_handle(id);
   if (!handle) {
     return NULL;
   }
 
-  GFont custom_font = fonts_load_custom_font(handle);
-  if (!custom_font) {
-    free(font);
-    return NULL;
+  SimplyFont *font = NULL;
+  while (!(font = malloc0(sizeof(*font)))) {
+    if (!simply_res_evict_image(self)) {
+      return NULL;
+    }
+  }
+
+  GFont custom_font = NULL;
+  while (!(custom_font = fonts_load_custom_font(handle))) {
+    if (!simply_res_evict_image(self)) {
+      free(font);
+      return NULL;
+    }
   }
 
+  font->id = id;
   font->font = custom_font;
 
-  list1_prepend(&self->fonts, &font->node);
+  index_link(FONT_INDEX(self), &font->common);
 
   window_stack_schedule_top_window_render();
 
-  return font->font;
+  return font;
 }
 
-GFont simply_res_auto_font(SimplyRes *self, uint32_t id) {
+static SimplyFont *auto_font(SimplyRes *self, uint32_t id) {
   if (!id) {
     return NULL;
   }
-  SimplyFont *font = (SimplyFont*) list1_find(self->fonts, id_filter, (void*)(uintptr_t) id);
+  SimplyFont *font = (SimplyFont*) index_find(FONT_INDEX(self), id);
   if (font) {
-    return font->font;
+    return font;
   }
   if (id <= self->num_bundled_res) {
-    return simply_res_add_custom_font(self, id);
+    return add_custom_font(self, id);
   }
   return NULL;
 }
 
+GFont simply_res_add_custom_font(SimplyRes *self, uint32_t id) {
+  SimplyFont *font = add_custom_font(self, id);
+  return font ? font->font : NULL;
+}
+
+GFont simply_res_auto_font(SimplyRes *self, uint32_t id) {
+  SimplyFont *font = auto_font(self, id);
+  return font ? font->font : NULL;
+}
+
+void simply_res_release_font(SimplyRes *self, uint32_t id) {
+  if (!id) {
+    return;
+  }
+  SimplyFont *font = (SimplyFont*) index_find(FONT_INDEX(self), id);
+  if (font && font->count) {
+    --font->count;
+  }
+}
+
+//! Moves the reference held to a font from the id it holds to a new id, loading the font if needed.
+//! The new font is retained first so that keeping the same font never reloads it.
+GFont simply_res_set_font_ref(SimplyRes *self, uint32_t *font_id, uint32_t id) {
+  SimplyFont *font = auto_font(self, id);
+  if (font) {
+    ++font->count;
+  }
+  simply_res_release_font(self, *font_id);
+  *font_id = font ? id : 0;
+  return font ? font->font : NULL;
+}
+
+static void destroy_unused_fonts(SimplyRes *self) {
+  for (List1Node *walk = self->fonts; walk;) {
+    SimplyFont *font = (SimplyFont*) walk;
+    walk = walk->next;
+    if (!font->count) {
+      destroy_font(self, font);
+    }
+  }
+}
+
 void simply_res_clear(SimplyRes *self) {
   while (self->images) {
     destroy_image(self, (SimplyImage*) self->images);
   }
 
-  while (self->fonts) {
-    destroy_font(self, (SimplyFont*) self->fonts);
-  }
+  destroy_unused_fonts(self);
 }
 
 SimplyRes *simply_res_create() {
   SimplyRes *self = malloc(sizeof(*self));
-  *self = (SimplyRes) { .images = NULL };
+  *self = (SimplyRes) { .images_budget = DEFAULT_IMAGES_BUDGET };
 
   while (resource_get_handle(self->num_bundled_res + 1)) {
     ++self->num_bundled_res;
@@ -234,5 +688,13 @@ SimplyRes *simply_res_create() {
 
 void simply_res_destroy(SimplyRes *self) {
   simply_res_clear(self);
+  while (self->fonts) {
+    destroy_font(self, (SimplyFont*) self->fonts);
+  }
+  while (self->image_pins) {
+    SimplyImagePin *pin = (SimplyImagePin*) self->image_pins;
+    index_unlink(PIN_INDEX(self), &pin->common);
+    free(pin);
+  }
   free(self);
 }
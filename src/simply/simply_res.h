@@ -4,6 +4,7 @@
 
 #include "util/color.h"
 #include "util/list1.h"
+#include "util/platform.h"
 
 #include <pebble.h>
 
@@ -11,19 +12,39 @@
 
 #define simply_res_get_font(self, id) simply_res_auto_font(self, id)
 
+//! Hash bucket counts, powers of two that keep chains short for the usual number of images and fonts
+#define SIMPLY_RES_IMAGE_BUCKETS IF_APLITE_ELSE(8, 32)
+#define SIMPLY_RES_FONT_BUCKETS 4
+
 typedef struct SimplyRes SimplyRes;
 
 struct SimplyRes {
   List1Node *images;
   List1Node *fonts;
+  //! Images referenced by a visible element, card imagefield, menu icon or action bar icon
+  List1Node *image_pins;
+  //! Hash chains indexing the above lists by id, linked and unlinked together with the lists
+  struct SimplyResItemCommon *image_buckets[SIMPLY_RES_IMAGE_BUCKETS];
+  struct SimplyResItemCommon *font_buckets[SIMPLY_RES_FONT_BUCKETS];
+  struct SimplyResItemCommon *pin_buckets[SIMPLY_RES_IMAGE_BUCKETS];
   uint32_t num_bundled_res;
+  //! Bytes held by all images, which are evicted down to the budget whenever an image is added
+  size_t images_size;
+  size_t images_budget;
+  //! Ticks on every image lookup so that images can be ordered by when they were last drawn
+  uint32_t images_clock;
+  //! Incremented whenever an image is added or destroyed so that cached renderings can be invalidated
+  uint16_t images_version;
+  //! Incremented whenever an image is evicted to make room, which signals memory pressure to other caches
+  uint16_t num_evictions;
 };
 
 typedef struct SimplyResItemCommon SimplyResItemCommon;
 
-#define SimplyResItemCommonDef { \
-  List1Node node;                \
-  uint32_t id;                   \
+#define SimplyResItemCommonDef {                 \
+  List1Node node;                                \
+  struct SimplyResItemCommon *bucket_next;       \
+  uint32_t id;                                   \
 }
 
 struct SimplyResItemCommon SimplyResItemCommonDef;
@@ -34,21 +55,59 @@ struct SimplyResItemCommon SimplyResItemCommonDef;
     struct SimplyResItemCommonDef;     \
   }
 
+typedef enum SimplyImageFormat SimplyImageFormat;
+
+//! Encodings of image data sent by JS. Raw formats are copied into the bitmap directly, with the
+//! palette colors of palettized formats first and rows that start on a byte boundary.
+enum SimplyImageFormat {
+  SimplyImageFormatRaw1Bit = 0,
+  SimplyImageFormatRaw1BitPalette,
+  SimplyImageFormatRaw2BitPalette,
+  SimplyImageFormatRaw4BitPalette,
+  SimplyImageFormatPng,
+};
+
 typedef struct SimplyImage SimplyImage;
 
+//! A sprite is an image whose bitmap is a sub-bitmap of an atlas image, identified by atlas_id.
+//! Sprites borrow the atlas pixels and are destroyed along with their atlas.
+//! Images received as PNG keep their compressed data and are only decoded into bitmap when they are
+//! looked up for drawing. The decoded bitmap is dropped first when memory is needed.
 struct SimplyImage {
   SimplyResItemCommonMember;
+  uint32_t atlas_id;
   uint8_t *bitmap_data;
   GBitmap *bitmap;
+  uint8_t *png_data;
+  uint16_t png_data_length;
+  //! Bounds of a sprite within its atlas
+  GRect source;
   GColor8 *palette;
+  //! Bytes accounted to this image in images_size
+  uint32_t size;
+  uint32_t drawn_at;
+  //! Number of this atlas's sprites that are pinned, which pins the atlas as well
+  uint16_t num_pinned_sprites;
   bool is_palette_black_and_white:1;
 };
 
+typedef struct SimplyImagePin SimplyImagePin;
+
+//! Counts the references to an image id. Pinned images and atlases with pinned sprites are never
+//! evicted, and pins outlive the image so that it stays protected once it is loaded again.
+struct SimplyImagePin {
+  SimplyResItemCommonMember;
+  uint16_t count;
+};
+
 typedef struct SimplyFont SimplyFont;
 
+//! Fonts are shared by every text that uses them. Fonts are counted while referenced by a stage
+//! element or card style and only unloaded by a clear once unreferenced.
 struct SimplyFont {
   SimplyResItemCommonMember;
   GFont font;
+  uint16_t count;
 };
 
 SimplyRes *simply_res_create();
@@ -56,12 +115,21 @@ void simply_res_destroy(SimplyRes *self);
 void simply_res_clear(SimplyRes *self);
 
 SimplyImage *simply_res_add_bundled_image(SimplyRes *self, uint32_t id);
-SimplyImage *simply_res_add_image(SimplyRes *self, uint32_t id, int16_t width, int16_t height,
-                                  uint8_t *pixels, uint16_t pixels_length);
+SimplyImage *simply_res_add_image(SimplyRes *self, uint32_t id, SimplyImageFormat format, int16_t width,
+                                  int16_t height, uint8_t *pixels, uint16_t pixels_length);
+uint32_t simply_res_get_image_formats(void);
+SimplyImage *simply_res_add_sprite(SimplyRes *self, uint32_t id, uint32_t atlas_id, GRect source);
 SimplyImage *simply_res_auto_image(SimplyRes *self, uint32_t id, bool is_placeholder);
 bool simply_res_evict_image(SimplyRes *self);
+void simply_res_set_image_budget(SimplyRes *self, size_t budget);
+
+void simply_res_pin_image(SimplyRes *self, uint32_t id);
+void simply_res_unpin_image(SimplyRes *self, uint32_t id);
+void simply_res_set_image_pin(SimplyRes *self, uint32_t *pinned_id, uint32_t id);
 
 GFont simply_res_add_custom_font(SimplyRes *self, uint32_t id);
 GFont simply_res_auto_font(SimplyRes *self, uint32_t id);
+GFont simply_res_set_font_ref(SimplyRes *self, uint32_t *font_id, uint32_t id);
+void simply_res_release_font(SimplyRes *self, uint32_t id);
 
 void simply_res_remove_image(SimplyRes *self, uint32_t id);
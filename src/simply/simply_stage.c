@@ -1,6 +1,7 @@
 #include "simply_stage.h"
 
 #include "simply_window.h"
+#include "simply_batch.h"
 #include "simply_res.h"
 #include "simply_msg.h"
 #include "simply_window_stack.h"
@@ -11,6 +12,7 @@
 #include "util/compat.h"
 #include "util/graphics.h"
 #include "util/inverter_layer.h"
+#include "util/math.h"
 #include "util/memory.h"
 #include "util/string.h"
 #include "util/window.h"
@@ -26,6 +28,7 @@ struct __attribute__((__packed__)) ElementInsertPacket {
   uint32_t id;
   SimplyElementType type:8;
   uint16_t index;
+  uint32_t parent;
 };
 
 typedef struct ElementRemovePacket ElementRemovePacket;
@@ -35,6 +38,24 @@ struct __attribute__((__packed__)) ElementRemovePacket {
   uint32_t id;
 };
 
+typedef enum ElementMovePosition ElementMovePosition;
+
+enum ElementMovePosition {
+  ElementMoveFront = 0,
+  ElementMoveBack,
+  ElementMoveAbove,
+  ElementMoveBelow,
+};
+
+typedef struct ElementMovePacket ElementMovePacket;
+
+struct __attribute__((__packed__)) ElementMovePacket {
+  Packet packet;
+  uint32_t id;
+  ElementMovePosition position:8;
+  uint32_t sibling;
+};
+
 typedef struct ElementCommonPacket ElementCommonPacket;
 
 struct __attribute__((__packed__)) ElementCommonPacket {
@@ -83,6 +104,82 @@ struct __attribute__((__packed__)) ElementImagePacket {
   GCompOp compositing:8;
 };
 
+typedef enum ElementDefineFlag ElementDefineFlag;
+
+enum ElementDefineFlag {
+  ElementDefineInsert = 1 << 0,
+  ElementDefineRadius = 1 << 1,
+  ElementDefineTextStyle = 1 << 2,
+  ElementDefineText = 1 << 3,
+  ElementDefineImage = 1 << 4,
+  ElementDefineStatic = 1 << 5,
+};
+
+typedef struct ElementDefinePacket ElementDefinePacket;
+
+struct __attribute__((__packed__)) ElementDefinePacket {
+  Packet packet;
+  uint32_t id;
+  SimplyElementType type:8;
+  uint8_t flags;
+  uint16_t index;
+  uint32_t parent;
+  GRect frame;
+  GColor8 background_color;
+  GColor8 border_color;
+  uint16_t radius;
+  uint32_t image;
+  GCompOp compositing:8;
+  GColor8 text_color;
+  GTextOverflowMode overflow_mode:8;
+  GTextAlignment alignment:8;
+  TimeUnits time_units:8;
+  uint32_t custom_font;
+  char buffer[];
+};
+
+typedef struct ElementPathPacket ElementPathPacket;
+
+struct __attribute__((__packed__)) ElementPathPacket {
+  Packet packet;
+  uint32_t id;
+  bool closed;
+  uint8_t stroke_width;
+  uint16_t num_points;
+  GPoint points[];
+};
+
+typedef struct ElementPathAppendPacket ElementPathAppendPacket;
+
+struct __attribute__((__packed__)) ElementPathAppendPacket {
+  Packet packet;
+  uint32_t id;
+  uint16_t num_points;
+  GPoint points[];
+};
+
+typedef struct ElementChartPacket ElementChartPacket;
+
+struct __attribute__((__packed__)) ElementChartPacket {
+  Packet packet;
+  uint32_t id;
+  SimplyChartMode mode:8;
+  bool auto_scale;
+  GColor8 color;
+  uint16_t capacity;
+  int16_t min;
+  int16_t max;
+};
+
+typedef struct ElementChartAppendPacket ElementChartAppendPacket;
+
+struct __attribute__((__packed__)) ElementChartAppendPacket {
+  Packet packet;
+  uint32_t id;
+  uint16_t num_samples;
+  int16_t samples[];
+};
+
 typedef struct ElementAnimatePacket ElementAnimatePacket;
 
 struct __attribute__((__packed__)) ElementAnimatePacket {
@@ -106,7 +203,8 @@ static void simply_stage_update(SimplyStage *self);
 static void simply_stage_update_ticker(SimplyStage *self);
 
 static SimplyElementCommon* simply_stage_auto_element(SimplyStage *self, uint32_t id, SimplyElementType type);
-static SimplyElementCommon* simply_stage_insert_element(SimplyStage *self, int index, SimplyElementCommon *element);
+static SimplyElementCommon* simply_stage_insert_element(SimplyStage *self, SimplyElementGroup *parent,
+                                                        int index, SimplyElementCommon *element);
 static SimplyElementCommon* simply_stage_remove_element(SimplyStage *self, SimplyElementCommon *element);
 
 static void simply_stage_set_element_frame(SimplyStage *self, SimplyElementCommon *element, GRect frame);
@@ -123,10 +221,6 @@ static bool send_animate_element_done(SimplyMsg *self, uint32_t id) {
   return simply_msg_send_packet(&packet.packet);
 }
 
-static bool id_filter(List1Node *node, void *data) {
-  return (((SimplyElementCommon*) node)->id == (uint32_t)(uintptr_t) data);
-}
-
 static bool animation_filter(List1Node *node, void *data) {
   return (((SimplyAnimation*) node)->animation == (PropertyAnimation*) data);
 }
@@ -135,17 +229,119 @@ static bool animation_element_filter(List1Node *node, void *data) {
   return (((SimplyAnimation*) node)->element == (SimplyElementCommon*) data);
 }
 
+static List2 *element_list(SimplyStage *self, SimplyElementCommon *element) {
+  return element->parent ? &element->parent->children : &self->stage_layer.elements;
+}
+
+static SimplyElementCommon *find_element(List2 *elements, uint32_t id) {
+  for (List2Node *walk = elements->head; walk; walk = walk->next) {
+    SimplyElementCommon *element = (SimplyElementCommon*) walk;
+    if (element->id == id) {
+      return element;
+    }
+    if (element->type == SimplyElementTypeGroup) {
+      SimplyElementCommon *child = find_element(&((SimplyElementGroup*) element)->children, id);
+      if (child) {
+        return child;
+      }
+    }
+  }
+  return NULL;
+}
+
+static SimplyElementGroup *get_group(SimplyStage *self, uint32_t id) {
+  SimplyElementCommon *element = simply_stage_get_element(self, id);
+  return (element && element->type == SimplyElementTypeGroup) ? (SimplyElementGroup*) element : NULL;
+}
+
+static GPoint element_offset(SimplyElementCommon *element) {
+  GPoint offset = GPointZero;
+  for (SimplyElementGroup *group = element->parent; group; group = group->parent) {
+    offset = gpoint_add(offset, group->frame.origin);
+  }
+  return offset;
+}
+
+static void sync_element_layers(SimplyStage *self, SimplyElementCommon *element) {
+  switch (element->type) {
+    default: break;
+    case SimplyElementTypeInverter: {
+      Layer *layer = inverter_layer_get_layer(((SimplyElementInverter*) element)->inverter_layer);
+      GRect frame = element->frame;
+      frame.origin = gpoint_add(frame.origin, element_offset(element));
+      layer_set_frame(layer, frame);
+      break;
+    }
+    case SimplyElementTypeGroup: {
+      List2Node *walk = ((SimplyElementGroup*) element)->children.head;
+      for (; walk; walk = walk->next) {
+        sync_element_layers(self, (SimplyElementCommon*) walk);
+      }
+      break;
+    }
+  }
+}
+
+static void invalidate_static_cache(SimplyStage *self) {
+  self->stage_layer.cache.is_valid = false;
+}
+
+static void destroy_static_cache(SimplyStage *self) {
+  SimplyStageCache *cache = &self->stage_layer.cache;
+  if (cache->bitmap) {
+    gbitmap_destroy(cache->bitmap);
+  }
+  *cache = (SimplyStageCache) { .bitmap = NULL };
+}
+
+static void mark_element_dirty(SimplyStage *self, SimplyElementCommon *element) {
+  for (; element; element = (SimplyElementCommon*) element->parent) {
+    if (element->is_static) {
+      invalidate_static_cache(self);
+      return;
+    }
+  }
+}
+
+static void simply_stage_update_element(SimplyStage *self, SimplyElementCommon *element) {
+  mark_element_dirty(self, element);
+  simply_stage_update(self);
+}
+
 static void destroy_element(SimplyStage *self, SimplyElementCommon *element) {
   if (!element) { return; }
-  list1_remove(&self->stage_layer.elements, &element->node);
+  invalidate_static_cache(self);
+  SimplyAnimation *animation = (SimplyAnimation*) list1_find(
+      self->stage_layer.animations, animation_element_filter, element);
+  if (animation) {
+    animation_unschedule((Animation*) animation->animation);
+  }
+  list2_remove(element_list(self, element), &element->node);
   switch (element->type) {
     default: break;
     case SimplyElementTypeText:
       free(((SimplyElementText*) element)->text);
+      simply_res_release_font(self->window.simply->res, ((SimplyElementText*) element)->custom_font);
+      break;
+    case SimplyElementTypeImage:
+      simply_res_unpin_image(self->window.simply->res, ((SimplyElementImage*) element)->image);
       break;
     case SimplyElementTypeInverter:
       inverter_layer_destroy(((SimplyElementInverter*) element)->inverter_layer);
       break;
+    case SimplyElementTypePath:
+      free(((SimplyElementPath*) element)->points);
+      break;
+    case SimplyElementTypeChart:
+      free(((SimplyElementChart*) element)->samples);
+      break;
+    case SimplyElementTypeGroup: {
+      SimplyElementGroup *group = (SimplyElementGroup*) element;
+      while (group->children.head) {
+        destroy_element(self, (SimplyElementCommon*) group->children.head);
+      }
+      break;
+    }
   }
   free(element);
 }
@@ -159,14 +355,19 @@ static void destroy_animation(SimplyStage *self, SimplyAnimation *animation) {
 void simply_stage_clear(SimplyStage *self) {
   simply_window_action_bar_clear(&self->window);
 
-  while (self->stage_layer.elements) {
-    destroy_element(self, (SimplyElementCommon*) self->stage_layer.elements);
+  while (self->stage_layer.elements.head) {
+    destroy_element(self, (SimplyElementCommon*) self->stage_layer.elements.head);
   }
 
   while (self->stage_layer.animations) {
     destroy_animation(self, (SimplyAnimation*) self->stage_layer.animations);
   }
 
+  destroy_static_cache(self);
+
+  self->stage_layer.content_max_y = 0;
+  self->stage_layer.is_content_max_y_valid = true;
+
   simply_stage_update_ticker(self);
 }
 
@@ -231,11 +432,384 @@ static void image_element_draw(GContext *ctx, SimplyStage *self, SimplyElementIm
       frame = gbitmap_get_bounds(image->bitmap);
     }
     graphics_draw_bitmap_centered(ctx, image->bitmap, frame);
+  } else if (element->image) {
+    self->stage_layer.is_image_missing = true;
   }
   rect_element_draw_border(ctx, self, (SimplyElementRect*) element);
   graphics_context_set_compositing_mode(ctx, GCompOpAssign);
 }
 
+static void path_element_draw(GContext *ctx, SimplyStage *self, SimplyElementPath *element) {
+  if (element->num_points < 2) {
+    return;
+  }
+  GPath path = {
+    .num_points = element->num_points,
+    .points = element->points,
+    .offset = element->frame.origin,
+  };
+  if (element->closed && element->background_color.a) {
+    graphics_context_set_fill_color(ctx, gcolor8_get(element->background_color));
+    gpath_draw_filled(ctx, &path);
+  }
+  if (!element->border_color.a) {
+    return;
+  }
+  graphics_context_set_stroke_color(ctx, gcolor8_get(element->border_color));
+  graphics_context_set_stroke_width(ctx, element->stroke_width ? element->stroke_width : 1);
+  if (element->closed) {
+    gpath_draw_outline(ctx, &path);
+  } else {
+    const GPoint offset = element->frame.origin;
+    GPoint prev = gpoint_add(element->points[0], offset);
+    for (uint16_t i = 1; i < element->num_points; i++) {
+      const GPoint point = gpoint_add(element->points[i], offset);
+      graphics_draw_line(ctx, prev, point);
+      prev = point;
+    }
+  }
+  graphics_context_set_stroke_width(ctx, 1);
+}
+
+static inline int16_t chart_get_sample(SimplyElementChart *element, uint16_t index) {
+  return element->samples[(element->head + index) % element->capacity];
+}
+
+static int16_t chart_sample_y(const GRect *frame, int16_t min, int16_t max, int16_t sample) {
+  if (max <= min) {
+    return frame->origin.y + frame->size.h / 2;
+  }
+  const int32_t clamped = (sample < min) ? min : (sample > max) ? max : sample;
+  return frame->origin.y + frame->size.h - 1 -
+      (clamped - min) * (frame->size.h - 1) / ((int32_t) max - min);
+}
+
+static void chart_element_draw(GContext *ctx, SimplyStage *self, SimplyElementChart *element) {
+  rect_element_draw_background(ctx, self, (SimplyElementRect*) element);
+  if (element->count && element->color.a) {
+    int16_t min = element->min;
+    int16_t max = element->max;
+    if (element->auto_scale) {
+      min = max = chart_get_sample(element, 0);
+      for (uint16_t i = 1; i < element->count; i++) {
+        const int16_t sample = chart_get_sample(element, i);
+        if (sample < min) { min = sample; }
+        if (sample > max) { max = sample; }
+      }
+    }
+
+    const GRect *frame = &element->frame;
+    // Samples are right-aligned so a partially filled chart scrolls in from the right
+    const uint16_t skip = element->capacity - element->count;
+    graphics_context_set_fill_color(ctx, gcolor8_get(element->color));
+    graphics_context_set_stroke_color(ctx, gcolor8_get(element->color));
+
+    if (element->mode == SimplyChartModeBar) {
+      const int16_t bottom = frame->origin.y + frame->size.h;
+      for (uint16_t i = 0; i < element->count; i++) {
+        const int16_t x0 = frame->origin.x + (skip + i) * frame->size.w / element->capacity;
+        const int16_t x1 = frame->origin.x + (skip + i + 1) * frame->size.w / element->capacity;
+        const int16_t y = chart_sample_y(frame, min, max, chart_get_sample(element, i));
+        graphics_fill_rect(ctx, GRect(x0, y, MAX(x1 - x0 - 1, 1), bottom - y), 0, GCornerNone);
+      }
+    } else {
+      const int16_t span = MAX(element->capacity - 1, 1);
+      GPoint prev = GPointZero;
+      for (uint16_t i = 0; i < element->count; i++) {
+        const GPoint point = {
+          .x = frame->origin.x + (skip + i) * (frame->size.w - 1) / span,
+          .y = chart_sample_y(frame, min, max, chart_get_sample(element, i)),
+        };
+        if (i) {
+          graphics_draw_line(ctx, prev, point);
+        } else if (element->count == 1) {
+          graphics_draw_pixel(ctx, point);
+        }
+        prev = point;
+      }
+    }
+  }
+  rect_element_draw_border(ctx, self, (SimplyElementRect*) element);
+}
+
+static void element_draw(GContext *ctx, SimplyStage *self, SimplyElementCommon *element);
+
+static void group_element_draw(GContext *ctx, SimplyStage *self, SimplyElementGroup *element) {
+  rect_element_draw_background(ctx, self, (SimplyElementRect*) element);
+  const GPoint offset = element->frame.origin;
+  for (List2Node *walk = element->children.head; walk; walk = walk->next) {
+    SimplyElementCommon *child = (SimplyElementCommon*) walk;
+    const GPoint origin = child->frame.origin;
+    child->frame.origin = gpoint_add(origin, offset);
+    element_draw(ctx, self, child);
+    child->frame.origin = origin;
+  }
+  rect_element_draw_border(ctx, self, (SimplyElementRect*) element);
+}
+
+static void element_draw(GContext *ctx, SimplyStage *self, SimplyElementCommon *element) {
+  switch (element->type) {
+    case SimplyElementTypeNone:
+      break;
+    case SimplyElementTypeRect:
+      rect_element_draw(ctx, self, (SimplyElementRect*) element);
+      break;
+    case SimplyElementTypeCircle:
+      circle_element_draw(ctx, self, (SimplyElementCircle*) element);
+      break;
+    case SimplyElementTypeText:
+      text_element_draw(ctx, self, (SimplyElementText*) element);
+      break;
+    case SimplyElementTypeImage:
+      image_element_draw(ctx, self, (SimplyElementImage*) element);
+      break;
+    case SimplyElementTypeInverter:
+      break;
+    case SimplyElementTypeGroup:
+      group_element_draw(ctx, self, (SimplyElementGroup*) element);
+      break;
+    case SimplyElementTypePath:
+      path_element_draw(ctx, self, (SimplyElementPath*) element);
+      break;
+    case SimplyElementTypeChart:
+      chart_element_draw(ctx, self, (SimplyElementChart*) element);
+      break;
+  }
+}
+
+static int16_t element_get_max_y(SimplyElementCommon *element) {
+  int16_t max_y = element->frame.origin.y + element->frame.size.h;
+  if (element->type == SimplyElementTypeGroup) {
+    List2Node *walk = ((SimplyElementGroup*) element)->children.head;
+    for (; walk; walk = walk->next) {
+      int16_t child_max_y = element->frame.origin.y + element_get_max_y((SimplyElementCommon*) walk);
+      if (child_max_y > max_y) {
+        max_y = child_max_y;
+      }
+    }
+  }
+  return max_y;
+}
+
+static int16_t element_get_stage_max_y(SimplyElementCommon *element) {
+  return element_offset(element).y + element_get_max_y(element);
+}
+
+static void invalidate_content_bounds(SimplyStage *self) {
+  self->stage_layer.is_content_max_y_valid = false;
+}
+
+//! Grows the content bounds to include an element that was inserted or moved
+static void extend_content_bounds(SimplyStage *self, SimplyElementCommon *element) {
+  const int16_t max_y = element_get_stage_max_y(element);
+  if (max_y > self->stage_layer.content_max_y) {
+    self->stage_layer.content_max_y = max_y;
+  }
+}
+
+//! Shrinking only requires a recompute when the element was at the bottom edge
+static void retract_content_bounds(SimplyStage *self, int16_t max_y) {
+  if (max_y >= self->stage_layer.content_max_y) {
+    invalidate_content_bounds(self);
+  }
+}
+
+static int16_t get_content_max_y(SimplyStage *self) {
+  SimplyStageLayer *stage_layer = &self->stage_layer;
+  if (!stage_layer->is_content_max_y_valid) {
+    stage_layer->content_max_y = 0;
+    for (List2Node *walk = stage_layer->elements.head; walk; walk = walk->next) {
+      extend_content_bounds(self, (SimplyElementCommon*) walk);
+    }
+    stage_layer->is_content_max_y_valid = true;
+  }
+  return stage_layer->content_max_y;
+}
+
+//! Resizes the scrollable content only when the content bounds moved
+static void sync_content_size(SimplyStage *self) {
+  Layer *layer = self->stage_layer.layer;
+  if (!layer || !self->window.is_scrollable) {
+    return;
+  }
+  GRect frame = layer_get_frame(layer);
+  const GRect viewport = layer_get_frame(scroll_layer_get_layer(self->window.scroll_layer));
+  const int16_t height = MAX(get_content_max_y(self), viewport.size.h);
+  if (frame.size.h == height && gpoint_equal(&frame.origin, &GPointZero)) {
+    return;
+  }
+  frame.origin = GPointZero;
+  frame.size.h = height;
+  layer_set_frame(layer, frame);
+  scroll_layer_set_content_size(self->window.scroll_layer, frame.size);
+}
+
+#ifdef PBL_SDK_3
+
+static bool element_is_cacheable(SimplyElementCommon *element, bool is_static) {
+  is_static = (is_static || element->is_static);
+  switch (element->type) {
+    case SimplyElementTypeInverter:
+      // Inverters are drawn by their own layer above the stage
+      return false;
+    case SimplyElementTypeText:
+      return (is_static && !((SimplyElementText*) element)->time_units);
+    case SimplyElementTypeGroup:
+      if (!is_static) {
+        return false;
+      }
+      for (List2Node *walk = ((SimplyElementGroup*) element)->children.head; walk; walk = walk->next) {
+        if (!element_is_cacheable((SimplyElementCommon*) walk, true)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return is_static;
+  }
+}
+
+static void element_extend_span_y(SimplyElementCommon *element, int16_t offset_y,
+                                  int16_t *min_y, int16_t *max_y) {
+  const int16_t origin_y = offset_y + element->frame.origin.y;
+  int16_t top = origin_y;
+  int16_t bottom = origin_y + element->frame.size.h;
+  switch (element->type) {
+    default: break;
+    case SimplyElementTypeCircle: {
+      const int16_t radius = ((SimplyElementCircle*) element)->radius;
+      top = origin_y - radius;
+      bottom = MAX(bottom, origin_y + radius + 1);
+      break;
+    }
+    case SimplyElementTypePath: {
+      SimplyElementPath *path = (SimplyElementPath*) element;
+      for (uint16_t i = 0; i < path->num_points; i++) {
+        top = MIN(top, origin_y + path->points[i].y - path->stroke_width);
+        bottom = MAX(bottom, origin_y + path->points[i].y + path->stroke_width + 1);
+      }
+      break;
+    }
+    case SimplyElementTypeGroup: {
+      List2Node *walk = ((SimplyElementGroup*) element)->children.head;
+      for (; walk; walk = walk->next) {
+        element_extend_span_y((SimplyElementCommon*) walk, origin_y, min_y, max_y);
+      }
+      break;
+    }
+  }
+  *min_y = MIN(*min_y, top);
+  *max_y = MAX(*max_y, bottom);
+}
+
+static GPoint get_screen_origin(SimplyStage *self, Layer *layer) {
+  Layer *window_layer = window_get_root_layer(self->window.window);
+  const GRect window_frame = layer_get_frame(window_layer);
+  const GRect window_bounds = layer_get_bounds(window_layer);
+  const GRect scroll_frame = layer_get_frame(scroll_layer_get_layer(self->window.scroll_layer));
+  const GRect frame = layer_get_frame(layer);
+  return GPoint(window_frame.origin.x + window_bounds.origin.x + scroll_frame.origin.x + frame.origin.x,
+                window_frame.origin.y + window_bounds.origin.y + scroll_frame.origin.y + frame.origin.y);
+}
+
+static void capture_static_cache(SimplyStage *self, GContext *ctx, GPoint origin, int16_t min_y,
+                                 int16_t max_y) {
+  SimplyStageCache *cache = &self->stage_layer.cache;
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    return;
+  }
+
+  const GBitmapFormat format = gbitmap_get_format(frame_buffer);
+  const GRect frame_bounds = gbitmap_get_bounds(frame_buffer);
+  const int16_t frame_min_y = MAX(origin.y + min_y, 0);
+  const int16_t frame_max_y = MIN(origin.y + max_y, frame_bounds.size.h);
+  // Round displays do not have uniform rows
+  if ((format != GBitmapFormat1Bit && format != GBitmapFormat8Bit) || frame_max_y <= frame_min_y) {
+    graphics_release_frame_buffer(ctx, frame_buffer);
+    return;
+  }
+
+  GSize size = GSize(frame_bounds.size.w, frame_max_y - frame_min_y);
+  if (cache->bitmap) {
+    GRect bounds = gbitmap_get_bounds(cache->bitmap);
+    if (!gsize_equal(&bounds.size, &size) || gbitmap_get_format(cache->bitmap) != format) {
+      gbitmap_destroy(cache->bitmap);
+      cache->bitmap = NULL;
+    }
+  }
+  if (!cache->bitmap) {
+    cache->bitmap = gbitmap_create_blank(size, format);
+  }
+
+  if (cache->bitmap) {
+    const uint16_t src_row_size = gbitmap_get_bytes_per_row(frame_buffer);
+    const uint16_t dst_row_size = gbitmap_get_bytes_per_row(cache->bitmap);
+    const uint16_t row_size = MIN(src_row_size, dst_row_size);
+    const uint8_t *src = gbitmap_get_data(frame_buffer) + frame_min_y * src_row_size;
+    uint8_t *dst = gbitmap_get_data(cache->bitmap);
+    for (int16_t y = frame_min_y; y < frame_max_y; y++) {
+      memcpy(dst, src, row_size);
+      src += src_row_size;
+      dst += dst_row_size;
+    }
+    cache->origin = origin;
+    cache->min_y = frame_min_y - origin.y;
+    cache->images_version = self->window.simply->res->images_version;
+    cache->background_color = self->window.background_color;
+    cache->is_valid = true;
+  }
+
+  graphics_release_frame_buffer(ctx, frame_buffer);
+}
+
+#endif
+
+//! Draws the leading run of static elements, from the cache when it is still valid.
+//! Returns the first element that still needs to be drawn.
+static SimplyElementCommon *static_elements_draw(GContext *ctx, SimplyStage *self, Layer *layer) {
+  SimplyElementCommon *element = (SimplyElementCommon*) self->stage_layer.elements.head;
+#ifdef PBL_SDK_3
+  // Scrolling moves the content under the screen, so the screen rows cannot be reused
+  if (self->window.is_scrollable) {
+    return element;
+  }
+
+  int16_t min_y = INT16_MAX;
+  int16_t max_y = INT16_MIN;
+  SimplyElementCommon *end = element;
+  for (; end && element_is_cacheable(end, false); end = (SimplyElementCommon*) end->node.next) {
+    element_extend_span_y(end, 0, &min_y, &max_y);
+  }
+  if (end == element) {
+    return element;
+  }
+
+  SimplyStageCache *cache = &self->stage_layer.cache;
+  const GPoint origin = get_screen_origin(self, layer);
+  if (cache->is_valid && cache->bitmap && gpoint_equal(&cache->origin, &origin) &&
+      cache->images_version == self->window.simply->res->images_version &&
+      gcolor8_equal(cache->background_color, self->window.background_color)) {
+    const GRect bounds = gbitmap_get_bounds(cache->bitmap);
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+    graphics_draw_bitmap_in_rect(ctx, cache->bitmap,
+                                 GRect(-origin.x, cache->min_y, bounds.size.w, bounds.size.h));
+    return end;
+  }
+
+  self->stage_layer.is_image_missing = false;
+  for (; element != end; element = (SimplyElementCommon*) element->node.next) {
+    element_draw(ctx, self, element);
+  }
+  if (self->stage_layer.is_image_missing) {
+    return element;
+  }
+  const GRect frame = layer_get_frame(layer);
+  capture_static_cache(self, ctx, origin, MAX(min_y, 0), MIN(max_y, frame.size.h));
+#endif
+  return element;
+}
+
 static void layer_update_callback(Layer *layer, GContext *ctx) {
   SimplyStage *self = *(void**) layer_get_data(layer);
 
@@ -249,38 +823,14 @@ static void layer_update_callback(Layer *layer, GContext *ctx) {
   graphics_context_set_fill_color(ctx, gcolor8_get(self->window.background_color));
   graphics_fill_rect(ctx, frame, 0, GCornerNone);
 
-  SimplyElementCommon *element = (SimplyElementCommon*) self->stage_layer.elements;
+  SimplyElementCommon *element = static_elements_draw(ctx, self, layer);
   while (element) {
-    int16_t max_y = element->frame.origin.y + element->frame.size.h;
-    if (max_y > frame.size.h) {
-      frame.size.h = max_y;
-    }
-    switch (element->type) {
-      case SimplyElementTypeNone:
-        break;
-      case SimplyElementTypeRect:
-        rect_element_draw(ctx, self, (SimplyElementRect*) element);
-        break;
-      case SimplyElementTypeCircle:
-        circle_element_draw(ctx, self, (SimplyElementCircle*) element);
-        break;
-      case SimplyElementTypeText:
-        text_element_draw(ctx, self, (SimplyElementText*) element);
-        break;
-      case SimplyElementTypeImage:
-        image_element_draw(ctx, self, (SimplyElementImage*) element);
-        break;
-      case SimplyElementTypeInverter:
-        break;
-    }
+    element_draw(ctx, self, element);
     element = (SimplyElementCommon*) element->node.next;
   }
 
-  if (self->window.is_scrollable) {
-    frame.origin = GPointZero;
-    layer_set_frame(layer, frame);
-    scroll_layer_set_content_size(self->window.scroll_layer, frame.size);
-  }
+  // Normally already applied by simply_stage_update, this catches toggling scrollable
+  sync_content_size(self);
 }
 
 static SimplyElementCommon *alloc_element(SimplyElementType type) {
@@ -290,6 +840,9 @@ static SimplyElementCommon *alloc_element(SimplyElementType type) {
     case SimplyElementTypeCircle: return malloc0(sizeof(SimplyElementCircle));
     case SimplyElementTypeText: return malloc0(sizeof(SimplyElementText));
     case SimplyElementTypeImage: return malloc0(sizeof(SimplyElementImage));
+    case SimplyElementTypeGroup: return malloc0(sizeof(SimplyElementGroup));
+    case SimplyElementTypePath: return malloc0(sizeof(SimplyElementPath));
+    case SimplyElementTypeChart: return malloc0(sizeof(SimplyElementChart));
     case SimplyElementTypeInverter: {
       SimplyElementInverter *element = malloc0(sizeof(SimplyElementInverter));
       if (!element) {
@@ -306,8 +859,7 @@ SimplyElementCommon *simply_stage_auto_element(SimplyStage *self, uint32_t id, S
   if (!id) {
     return NULL;
   }
-  SimplyElementCommon *element = (SimplyElementCommon*) list1_find(
-      self->stage_layer.elements, id_filter, (void*)(uintptr_t) id);
+  SimplyElementCommon *element = find_element(&self->stage_layer.elements, id);
   if (element) {
     return element;
   }
@@ -321,8 +873,17 @@ SimplyElementCommon *simply_stage_auto_element(SimplyStage *self, uint32_t id, S
   return element;
 }
 
-SimplyElementCommon *simply_stage_insert_element(SimplyStage *self, int index, SimplyElementCommon *element) {
+SimplyElementCommon *simply_stage_insert_element(SimplyStage *self, SimplyElementGroup *parent,
+                                                 int index, SimplyElementCommon *element) {
+  for (SimplyElementGroup *walk = parent; walk; walk = walk->parent) {
+    if ((SimplyElementCommon*) walk == element) {
+      // A group cannot be inserted into itself or one of its descendants
+      return NULL;
+    }
+  }
   simply_stage_remove_element(self, element);
+  invalidate_static_cache(self);
+  element->parent = parent;
   switch (element->type) {
     default: break;
     case SimplyElementTypeInverter:
@@ -330,29 +891,65 @@ SimplyElementCommon *simply_stage_insert_element(SimplyStage *self, int index, S
           inverter_layer_get_layer(((SimplyElementInverter*) element)->inverter_layer));
       break;
   }
-  return (SimplyElementCommon*) list1_insert(&self->stage_layer.elements, index, &element->node);
+  list2_insert(element_list(self, element), index, &element->node);
+  sync_element_layers(self, element);
+  extend_content_bounds(self, element);
+  return element;
 }
 
 SimplyElementCommon *simply_stage_remove_element(SimplyStage *self, SimplyElementCommon *element) {
+  invalidate_static_cache(self);
+  retract_content_bounds(self, element_get_stage_max_y(element));
   switch (element->type) {
     default: break;
     case SimplyElementTypeInverter:
       layer_remove_from_parent(inverter_layer_get_layer(((SimplyElementInverter*) element)->inverter_layer));
       break;
   }
-  return (SimplyElementCommon*) list1_remove(&self->stage_layer.elements, &element->node);
+  return (SimplyElementCommon*) list2_remove(element_list(self, element), &element->node);
+}
+
+//! Moves an element within its group or the stage in constant time.
+//! The front is drawn last, on top of the other elements, and a sibling must share the same parent.
+static bool simply_stage_move_element(SimplyStage *self, SimplyElementCommon *element,
+                                      ElementMovePosition position, SimplyElementCommon *sibling) {
+  List2 *list = element_list(self, element);
+  if (!list2_contains(list, &element->node)) {
+    return false;
+  }
+  const bool is_relative = (position == ElementMoveAbove || position == ElementMoveBelow);
+  if (is_relative && (!sibling || sibling == element || sibling->parent != element->parent)) {
+    return false;
+  }
+  invalidate_static_cache(self);
+  list2_remove(list, &element->node);
+  switch (position) {
+    case ElementMoveFront:
+      list2_append(list, &element->node);
+      break;
+    case ElementMoveBack:
+      list2_prepend(list, &element->node);
+      break;
+    case ElementMoveAbove:
+      list2_insert_after(list, &sibling->node, &element->node);
+      break;
+    case ElementMoveBelow:
+      list2_insert_before(list, &sibling->node, &element->node);
+      break;
+  }
+  return true;
 }
 
 void simply_stage_set_element_frame(SimplyStage *self, SimplyElementCommon *element, GRect frame) {
   grect_standardize(&frame);
+  const int16_t prev_max_y = element_get_stage_max_y(element);
   element->frame = frame;
-  switch (element->type) {
-    default: break;
-    case SimplyElementTypeInverter: {
-      Layer *layer = inverter_layer_get_layer(((SimplyElementInverter*) element)->inverter_layer);
-      layer_set_frame(layer, element->frame);
-      break;
-    }
+  sync_element_layers(self, element);
+  mark_element_dirty(self, element);
+  if (element_get_stage_max_y(element) < prev_max_y) {
+    retract_content_bounds(self, prev_max_y);
+  } else {
+    extend_content_bounds(self, element);
   }
 }
 
@@ -454,7 +1051,6 @@ static void window_appear(Window *window) {
 static void window_disappear(Window *window) {
   SimplyStage *self = window_get_user_data(window);
   if (simply_window_disappear(&self->window)) {
-    simply_res_clear(self->window.simply->res);
     simply_stage_clear(self);
   }
 }
@@ -465,11 +1061,17 @@ static void window_unload(Window *window) {
   layer_destroy(self->stage_layer.layer);
   self->window.layer = self->stage_layer.layer = NULL;
 
+  destroy_static_cache(self);
+
   simply_window_unload(&self->window);
 }
 
 void simply_stage_update(SimplyStage *self) {
+  if (simply_batch_defer(self->window.simply->batch, (SimplyBatchCallback) simply_stage_update, self)) {
+    return;
+  }
   if (self->stage_layer.layer) {
+    sync_content_size(self);
     layer_mark_dirty(self->stage_layer.layer);
   }
 }
@@ -478,17 +1080,25 @@ static void handle_tick(struct tm *tick_time, TimeUnits units_changed) {
   window_stack_schedule_top_window_render();
 }
 
-void simply_stage_update_ticker(SimplyStage *self) {
+static TimeUnits get_time_units(List2Node *elements) {
   TimeUnits units = 0;
 
-  SimplyElementCommon *element = (SimplyElementCommon*) self->stage_layer.elements;
+  SimplyElementCommon *element = (SimplyElementCommon*) elements;
   while (element) {
     if (element->type == SimplyElementTypeText) {
       units |= ((SimplyElementText*) element)->time_units;
+    } else if (element->type == SimplyElementTypeGroup) {
+      units |= get_time_units(((SimplyElementGroup*) element)->children.head);
     }
     element = (SimplyElementCommon*) element->node.next;
   }
 
+  return units;
+}
+
+void simply_stage_update_ticker(SimplyStage *self) {
+  TimeUnits units = get_time_units(self->stage_layer.elements.head);
+
   if (units) {
     tick_timer_service_subscribe(units, handle_tick);
   } else {
@@ -502,34 +1112,80 @@ static void handle_stage_clear_packet(Simply *simply, Packet *data) {
 
 static void handle_element_insert_packet(Simply *simply, Packet *data) {
   ElementInsertPacket *packet = (ElementInsertPacket*) data;
+  SimplyElementGroup *parent = get_group(simply->stage, packet->parent);
+  if (packet->parent && !parent) {
+    return;
+  }
   SimplyElementCommon *element = simply_stage_auto_element(simply->stage, packet->id, packet->type);
   if (!element) {
     return;
   }
-  simply_stage_insert_element(simply->stage, packet->index, element);
+  simply_stage_insert_element(simply->stage, parent, packet->index, element);
   simply_stage_update(simply->stage);
 }
 
 static void handle_element_remove_packet(Simply *simply, Packet *data) {
-  ElementInsertPacket *packet = (ElementInsertPacket*) data;
+  ElementRemovePacket *packet = (ElementRemovePacket*) data;
   SimplyElementCommon *element = simply_stage_get_element(simply->stage, packet->id);
   if (!element) {
     return;
   }
   simply_stage_remove_element(simply->stage, element);
+  destroy_element(simply->stage, element);
+  simply_stage_update_ticker(simply->stage);
   simply_stage_update(simply->stage);
 }
 
+static void set_element_common(SimplyStage *self, SimplyElementCommon *element, GRect frame,
+                               GColor8 background_color, GColor8 border_color) {
+  simply_stage_set_element_frame(self, element, frame);
+  element->background_color = background_color;
+  element->border_color = border_color;
+}
+
+static void set_element_text(SimplyStage *self, SimplyElementText *element, const char *text,
+                             TimeUnits time_units) {
+  if (element->time_units != time_units) {
+    element->time_units = time_units;
+    simply_stage_update_ticker(self);
+  }
+  strset(&element->text, text);
+}
+
+static void set_element_text_style(SimplyStage *self, SimplyElementText *element, GColor8 color,
+                                   GTextOverflowMode overflow_mode, GTextAlignment alignment,
+                                   uint32_t custom_font, const char *system_font) {
+  element->text_color = color;
+  element->overflow_mode = overflow_mode;
+  element->alignment = alignment;
+  if (custom_font) {
+    element->font = simply_res_set_font_ref(self->window.simply->res, &element->custom_font, custom_font);
+  } else if (system_font[0]) {
+    simply_res_set_font_ref(self->window.simply->res, &element->custom_font, 0);
+    element->font = fonts_get_system_font(system_font);
+  }
+}
+
+static void handle_element_move_packet(Simply *simply, Packet *data) {
+  ElementMovePacket *packet = (ElementMovePacket*) data;
+  SimplyElementCommon *element = simply_stage_get_element(simply->stage, packet->id);
+  SimplyElementCommon *sibling = NULL;
+  if (!element || (packet->sibling && !(sibling = simply_stage_get_element(simply->stage, packet->sibling)))) {
+    return;
+  }
+  if (simply_stage_move_element(simply->stage, element, packet->position, sibling)) {
+    simply_stage_update(simply->stage);
+  }
+}
+
 static void handle_element_common_packet(Simply *simply, Packet *data) {
   ElementCommonPacket *packet = (ElementCommonPacket*) data;
   SimplyElementCommon *element = simply_stage_get_element(simply->stage, packet->id);
   if (!element) {
     return;
   }
-  simply_stage_set_element_frame(simply->stage, element, packet->frame);
-  element->background_color = packet->background_color;
-  element->border_color = packet->border_color;
-  simply_stage_update(simply->stage);
+  set_element_common(simply->stage, element, packet->frame, packet->background_color, packet->border_color);
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
 }
 
 static void handle_element_radius_packet(Simply *simply, Packet *data) {
@@ -539,7 +1195,7 @@ static void handle_element_radius_packet(Simply *simply, Packet *data) {
     return;
   }
   element->radius = packet->radius;
-  simply_stage_update(simply->stage);
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
 };
 
 static void handle_element_text_packet(Simply *simply, Packet *data) {
@@ -548,12 +1204,8 @@ static void handle_element_text_packet(Simply *simply, Packet *data) {
   if (!element) {
     return;
   }
-  if (element->time_units != packet->time_units) {
-    element->time_units = packet->time_units;
-    simply_stage_update_ticker(simply->stage);
-  }
-  strset(&element->text, packet->text);
-  simply_stage_update(simply->stage);
+  set_element_text(simply->stage, element, packet->text, packet->time_units);
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
 }
 
 static void handle_element_text_style_packet(Simply *simply, Packet *data) {
@@ -562,15 +1214,9 @@ static void handle_element_text_style_packet(Simply *simply, Packet *data) {
   if (!element) {
     return;
   }
-  element->text_color = packet->color;
-  element->overflow_mode = packet->overflow_mode;
-  element->alignment = packet->alignment;
-  if (packet->custom_font) {
-    element->font = simply_res_get_font(simply->res, packet->custom_font);
-  } else if (packet->system_font[0]) {
-    element->font = fonts_get_system_font(packet->system_font);
-  }
-  simply_stage_update(simply->stage);
+  set_element_text_style(simply->stage, element, packet->color, packet->overflow_mode, packet->alignment,
+                         packet->custom_font, packet->system_font);
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
 }
 
 static void handle_element_image_packet(Simply *simply, Packet *data) {
@@ -579,9 +1225,163 @@ static void handle_element_image_packet(Simply *simply, Packet *data) {
   if (!element) {
     return;
   }
-  element->image = packet->image;
+  simply_res_set_image_pin(simply->res, &element->image, packet->image);
   element->compositing = packet->compositing;
-  simply_stage_update(simply->stage);
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
+}
+
+//! Limits a count of trailing items to the number that fit within the packet's length
+static uint16_t get_packet_item_count(Packet *data, const void *items, size_t item_size, uint16_t count) {
+  const size_t offset = (const uint8_t*) items - (const uint8_t*) data;
+  const size_t available = (data->length > offset) ? (data->length - offset) / item_size : 0;
+  return MIN(count, available);
+}
+
+static bool append_path_points(SimplyElementPath *element, const void *points, uint16_t num_points) {
+  const uint32_t needed = element->num_points + num_points;
+  if (needed > UINT16_MAX) {
+    return false;
+  }
+  if (needed > element->capacity) {
+    // Grow geometrically so that streamed appends do not realloc on every packet
+    uint16_t capacity = MIN(MAX(needed, element->capacity * 2u), UINT16_MAX);
+    GPoint *buffer = realloc(element->points, capacity * sizeof(GPoint));
+    if (!buffer && capacity > needed) {
+      buffer = realloc(element->points, (capacity = needed) * sizeof(GPoint));
+    }
+    if (!buffer) {
+      return false;
+    }
+    element->points = buffer;
+    element->capacity = capacity;
+  }
+  memcpy(&element->points[element->num_points], points, num_points * sizeof(GPoint));
+  element->num_points = needed;
+  return true;
+}
+
+static SimplyElementPath *get_path_element(SimplyStage *self, uint32_t id) {
+  SimplyElementCommon *element = simply_stage_get_element(self, id);
+  return (element && element->type == SimplyElementTypePath) ? (SimplyElementPath*) element : NULL;
+}
+
+static void handle_element_path_packet(Simply *simply, Packet *data) {
+  ElementPathPacket *packet = (ElementPathPacket*) data;
+  SimplyElementPath *element = get_path_element(simply->stage, packet->id);
+  if (!element) {
+    return;
+  }
+  element->closed = packet->closed;
+  element->stroke_width = packet->stroke_width;
+  element->num_points = 0;
+  append_path_points(element, packet->points,
+                     get_packet_item_count(data, packet->points, sizeof(GPoint), packet->num_points));
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
+}
+
+static void handle_element_path_append_packet(Simply *simply, Packet *data) {
+  ElementPathAppendPacket *packet = (ElementPathAppendPacket*) data;
+  SimplyElementPath *element = get_path_element(simply->stage, packet->id);
+  if (!element) {
+    return;
+  }
+  append_path_points(element, packet->points,
+                     get_packet_item_count(data, packet->points, sizeof(GPoint), packet->num_points));
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
+}
+
+static void handle_element_chart_packet(Simply *simply, Packet *data) {
+  ElementChartPacket *packet = (ElementChartPacket*) data;
+  SimplyElementChart *element = (SimplyElementChart*) simply_stage_get_element(simply->stage, packet->id);
+  if (!element || element->type != SimplyElementTypeChart) {
+    return;
+  }
+  if (packet->capacity != element->capacity) {
+    free(element->samples);
+    element->samples = NULL;
+    element->capacity = 0;
+    if (packet->capacity) {
+      while (!(element->samples = malloc(packet->capacity * sizeof(int16_t)))) {
+        if (!simply_res_evict_image(simply->res)) {
+          break;
+        }
+      }
+      if (element->samples) {
+        element->capacity = packet->capacity;
+      }
+    }
+  }
+  element->head = 0;
+  element->count = 0;
+  element->mode = packet->mode;
+  element->auto_scale = packet->auto_scale;
+  element->color = packet->color;
+  element->min = packet->min;
+  element->max = packet->max;
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
+}
+
+static void handle_element_chart_append_packet(Simply *simply, Packet *data) {
+  ElementChartAppendPacket *packet = (ElementChartAppendPacket*) data;
+  SimplyElementChart *element = (SimplyElementChart*) simply_stage_get_element(simply->stage, packet->id);
+  if (!element || element->type != SimplyElementTypeChart || !element->capacity) {
+    return;
+  }
+  const uint8_t *samples = (const uint8_t*) packet->samples;
+  const uint16_t num_samples = get_packet_item_count(data, samples, sizeof(int16_t), packet->num_samples);
+  for (uint16_t i = 0; i < num_samples; i++) {
+    int16_t sample;
+    memcpy(&sample, &samples[i * sizeof(int16_t)], sizeof(sample));
+    element->samples[(element->head + element->count) % element->capacity] = sample;
+    if (element->count == element->capacity) {
+      element->head = (element->head + 1) % element->capacity;
+    } else {
+      element->count++;
+    }
+  }
+  simply_stage_update_element(simply->stage, (SimplyElementCommon*) element);
+}
+
+static void handle_element_define_packet(Simply *simply, Packet *data) {
+  ElementDefinePacket *packet = (ElementDefinePacket*) data;
+  SimplyStage *self = simply->stage;
+  const bool is_insert = (packet->flags & ElementDefineInsert);
+  SimplyElementGroup *parent = get_group(self, packet->parent);
+  if (is_insert && packet->parent && !parent) {
+    return;
+  }
+  SimplyElementCommon *element = simply_stage_auto_element(
+      self, packet->id, is_insert ? packet->type : SimplyElementTypeNone);
+  if (!element) {
+    return;
+  }
+  if (is_insert) {
+    simply_stage_insert_element(self, parent, packet->index, element);
+  }
+  set_element_common(self, element, packet->frame, packet->background_color, packet->border_color);
+  if (packet->flags & ElementDefineRadius) {
+    ((SimplyElementRect*) element)->radius = packet->radius;
+  }
+  const char *system_font = packet->buffer;
+  const char *text = system_font + strlen(system_font) + 1;
+  if (packet->flags & ElementDefineTextStyle) {
+    set_element_text_style(self, (SimplyElementText*) element, packet->text_color, packet->overflow_mode,
+                           packet->alignment, packet->custom_font, system_font);
+  }
+  if (packet->flags & ElementDefineText) {
+    set_element_text(self, (SimplyElementText*) element, text, packet->time_units);
+  }
+  if (packet->flags & ElementDefineImage) {
+    simply_res_set_image_pin(self->window.simply->res, &((SimplyElementImage*) element)->image,
+                             packet->image);
+    ((SimplyElementImage*) element)->compositing = packet->compositing;
+  }
+  const bool is_static = (packet->flags & ElementDefineStatic);
+  if (element->is_static != is_static) {
+    element->is_static = is_static;
+    invalidate_static_cache(self);
+  }
+  simply_stage_update_element(self, element);
 }
 
 static void handle_element_animate_packet(Simply *simply, Packet *data) {
@@ -630,6 +1430,24 @@ bool simply_stage_handle_packet(Simply *simply, Packet *packet) {
     case CommandElementAnimate:
       handle_element_animate_packet(simply, packet);
       return true;
+    case CommandElementDefine:
+      handle_element_define_packet(simply, packet);
+      return true;
+    case CommandElementPath:
+      handle_element_path_packet(simply, packet);
+      return true;
+    case CommandElementPathAppend:
+      handle_element_path_append_packet(simply, packet);
+      return true;
+    case CommandElementChart:
+      handle_element_chart_packet(simply, packet);
+      return true;
+    case CommandElementChartAppend:
+      handle_element_chart_append_packet(simply, packet);
+      return true;
+    case CommandElementMove:
+      handle_element_move_packet(simply, packet);
+      return true;
   }
   return false;
 }
@@ -8,6 +8,7 @@
 
 #include "util/inverter_layer.h"
 #include "util/list1.h"
+#include "util/list2.h"
 #include "util/color.h"
 
 #include <pebble.h>
@@ -29,12 +30,42 @@ enum SimplyElementType {
   SimplyElementTypeText = 3,
   SimplyElementTypeImage = 4,
   SimplyElementTypeInverter = 5,
+  SimplyElementTypeGroup = 6,
+  SimplyElementTypePath = 7,
+  SimplyElementTypeChart = 8,
+};
+
+typedef enum SimplyChartMode SimplyChartMode;
+
+enum SimplyChartMode {
+  SimplyChartModeLine = 0,
+  SimplyChartModeBar = 1,
+};
+
+typedef struct SimplyStageCache SimplyStageCache;
+
+//! Framebuffer rows holding the rendering of the leading run of static elements.
+//! The rows span the full framebuffer width so the copy is independent of the pixel format.
+struct SimplyStageCache {
+  GBitmap *bitmap;
+  GPoint origin;
+  int16_t min_y;
+  uint16_t images_version;
+  GColor8 background_color;
+  bool is_valid;
 };
 
 struct SimplyStageLayer {
   Layer *layer;
-  List1Node *elements;
+  List2 elements;
   List1Node *animations;
+  SimplyStageCache cache;
+  //! Set when an image element is drawn without its bitmap, such as when decoding it failed.
+  //! The static cache is not captured then since it would keep the missing image.
+  bool is_image_missing;
+  //! Bottom edge of all elements, kept up to date as elements change for sizing the scroll layer
+  int16_t content_max_y;
+  bool is_content_max_y_valid;
 };
 
 struct SimplyStage {
@@ -44,13 +75,17 @@ struct SimplyStage {
 
 typedef struct SimplyElementCommon SimplyElementCommon;
 
-#define SimplyElementCommonDef { \
-  List1Node node;                \
-  uint32_t id;                   \
-  SimplyElementType type;        \
-  GRect frame;                   \
-  GColor8 background_color;      \
-  GColor8 border_color;          \
+typedef struct SimplyElementGroup SimplyElementGroup;
+
+#define SimplyElementCommonDef {     \
+  List2Node node;                    \
+  uint32_t id;                       \
+  SimplyElementType type;            \
+  struct SimplyElementGroup *parent; \
+  GRect frame;                       \
+  GColor8 background_color;          \
+  GColor8 border_color;              \
+  bool is_static;                    \
 }
 
 struct SimplyElementCommon SimplyElementCommonDef;
@@ -79,6 +114,8 @@ struct SimplyElementText {
   };
   char *text;
   GFont font;
+  //! Resource id of the custom font referenced by this element, 0 for a system font
+  uint32_t custom_font;
   TimeUnits time_units:8;
   GColor8 text_color;
   GTextOverflowMode overflow_mode:2;
@@ -103,6 +140,45 @@ struct SimplyElementInverter {
   InverterLayer *inverter_layer;
 };
 
+//! A group translates its children by its frame origin when drawn.
+//! Moving, removing or re-inserting a group applies to all of its children at once.
+struct SimplyElementGroup {
+  union {
+    struct SimplyElementRect common;
+    struct SimplyElementCommonDef;
+  };
+  List2 children;
+};
+
+typedef struct SimplyElementPath SimplyElementPath;
+
+//! A path draws a polyline, or a polygon when closed, through points relative to its frame origin.
+struct SimplyElementPath {
+  SimplyElementCommonMember;
+  GPoint *points;
+  uint16_t num_points;
+  uint16_t capacity;
+  uint8_t stroke_width;
+  bool closed;
+};
+
+typedef struct SimplyElementChart SimplyElementChart;
+
+//! A chart plots the samples of a fixed-capacity ring buffer, oldest on the left.
+//! Once full, each appended sample overwrites the oldest one.
+struct SimplyElementChart {
+  SimplyElementCommonMember;
+  int16_t *samples;
+  uint16_t capacity;
+  uint16_t head;
+  uint16_t count;
+  int16_t min;
+  int16_t max;
+  GColor8 color;
+  SimplyChartMode mode:8;
+  bool auto_scale;
+};
+
 typedef struct SimplyAnimation SimplyAnimation;
 
 struct SimplyAnimation {
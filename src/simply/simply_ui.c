@@ -1,5 +1,6 @@
 #include "simply_ui.h"
 
+#include "simply_batch.h"
 #include "simply_msg.h"
 #include "simply_res.h"
 #include "simply_window_stack.h"
@@ -83,7 +84,24 @@ struct __attribute__((__packed__)) CardStylePacket {
   uint8_t style;
 };
 
+typedef struct CardDefinePacket CardDefinePacket;
+
+struct __attribute__((__packed__)) CardDefinePacket {
+  Packet packet;
+  uint8_t clear_flags;
+  uint8_t text_mask;
+  uint8_t image_mask;
+  bool has_style;
+  uint8_t style;
+  GColor8 text_color[NumUiTextfields];
+  uint32_t image[NumUiImagefields];
+  char buffer[];
+};
+
 static void mark_dirty(SimplyUi *self) {
+  if (simply_batch_defer(self->window.simply->batch, (SimplyBatchCallback) mark_dirty, self)) {
+    return;
+  }
   if (self->ui_layer.layer) {
     layer_mark_dirty(self->ui_layer.layer);
   }
@@ -101,20 +119,16 @@ void simply_ui_clear(SimplyUi *self, uint32_t clear_mask) {
     }
   }
   if (clear_mask & (1 << ClearImage)) {
-    memset(self->ui_layer.imagefields, 0, sizeof(self->ui_layer.imagefields));
+    for (int imagefield_id = 0; imagefield_id < NumUiImagefields; ++imagefield_id) {
+      simply_ui_set_image(self, imagefield_id, 0);
+    }
   }
 }
 
 void simply_ui_set_style(SimplyUi *self, int style_index) {
-  if (self->ui_layer.custom_body_font) {
-    fonts_unload_custom_font(self->ui_layer.custom_body_font);
-    self->ui_layer.custom_body_font = NULL;
-  }
   self->ui_layer.style = &STYLES[style_index];
-  if (self->ui_layer.style->custom_body_font_id) {
-    self->ui_layer.custom_body_font = fonts_load_custom_font(
-        resource_get_handle(self->ui_layer.style->custom_body_font_id));
-  }
+  self->ui_layer.custom_body_font = simply_res_set_font_ref(
+      self->window.simply->res, &self->ui_layer.custom_body_font_id, self->ui_layer.style->custom_body_font_id);
   mark_dirty(self);
 }
 
@@ -131,6 +145,11 @@ void simply_ui_set_text_color(SimplyUi *self, SimplyUiTextfieldId textfield_id,
   mark_dirty(self);
 }
 
+void simply_ui_set_image(SimplyUi *self, SimplyUiImagefieldId imagefield_id, uint32_t id) {
+  simply_res_set_image_pin(self->window.simply->res, &self->ui_layer.imagefields[imagefield_id], id);
+  mark_dirty(self);
+}
+
 static void layer_update_callback(Layer *layer, GContext *ctx) {
   SimplyUi *self = *(void**) layer_get_data(layer);
 
@@ -329,9 +348,7 @@ static void window_appear(Window *window) {
 
 static void window_disappear(Window *window) {
   SimplyUi *self = window_get_user_data(window);
-  if (simply_window_disappear(&self->window)) {
-    simply_res_clear(self->window.simply->res);
-  }
+  simply_window_disappear(&self->window);
 }
 
 static void window_unload(Window *window) {
@@ -366,8 +383,7 @@ static void handle_card_image_packet(Simply *simply, Packet *data) {
   if (imagefield_id >= NumUiImagefields) {
     return;
   }
-  simply->ui->ui_layer.imagefields[imagefield_id] = packet->image;
-  window_stack_schedule_top_window_render();
+  simply_ui_set_image(simply->ui, imagefield_id, packet->image);
 }
 
 static void handle_card_style_packet(Simply *simply, Packet *data) {
@@ -375,6 +391,31 @@ static void handle_card_style_packet(Simply *simply, Packet *data) {
   simply_ui_set_style(simply->ui, packet->style);
 }
 
+static void handle_card_define_packet(Simply *simply, Packet *data) {
+  CardDefinePacket *packet = (CardDefinePacket*) data;
+  SimplyUi *self = simply->ui;
+  simply_ui_clear(self, packet->clear_flags);
+  if (packet->has_style) {
+    simply_ui_set_style(self, packet->style);
+  }
+  const char *text = packet->buffer;
+  for (int textfield_id = 0; textfield_id < NumUiTextfields; ++textfield_id) {
+    if (packet->text_mask & (1 << textfield_id)) {
+      simply_ui_set_text(self, textfield_id, text);
+      if (!gcolor8_equal(packet->text_color[textfield_id], GColor8ClearWhite)) {
+        simply_ui_set_text_color(self, textfield_id, packet->text_color[textfield_id]);
+      }
+    }
+    text += strlen(text) + 1;
+  }
+  for (int imagefield_id = 0; imagefield_id < NumUiImagefields; ++imagefield_id) {
+    if (packet->image_mask & (1 << imagefield_id)) {
+      simply_ui_set_image(self, imagefield_id, packet->image[imagefield_id]);
+    }
+  }
+  mark_dirty(self);
+}
+
 bool simply_ui_handle_packet(Simply *simply, Packet *packet) {
   switch (packet->type) {
     case CommandCardClear:
@@ -389,6 +430,9 @@ bool simply_ui_handle_packet(Simply *simply, Packet *packet) {
     case CommandCardStyle:
       handle_card_style_packet(simply, packet);
       return true;
+    case CommandCardDefine:
+      handle_card_define_packet(simply, packet);
+      return true;
   }
   return false;
 }
@@ -420,9 +464,6 @@ void simply_ui_destroy(SimplyUi *self) {
 
   simply_ui_clear(self, ~0);
 
-  fonts_unload_custom_font(self->ui_layer.custom_body_font);
-  self->ui_layer.custom_body_font = NULL;
-
   simply_window_deinit(&self->window);
 
   free(self);
@@ -41,6 +41,7 @@ struct SimplyUiLayer {
   SimplyUiTextfield textfields[3];
   uint32_t imagefields[3];
   GFont custom_body_font;
+  uint32_t custom_body_font_id;
 };
 
 typedef struct SimplyUi SimplyUi;
@@ -58,5 +59,6 @@ void simply_ui_clear(SimplyUi *self, uint32_t clear_mask);
 void simply_ui_set_style(SimplyUi *self, int style_index);
 void simply_ui_set_text(SimplyUi *self, SimplyUiTextfieldId textfield_id, const char *str);
 void simply_ui_set_text_color(SimplyUi *self, SimplyUiTextfieldId textfield_id, GColor8 color);
+void simply_ui_set_image(SimplyUi *self, SimplyUiImagefieldId imagefield_id, uint32_t id);
 
 bool simply_ui_handle_packet(Simply *simply, Packet *packet);
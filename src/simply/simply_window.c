@@ -172,6 +172,7 @@ void simply_window_set_action_bar_icon(SimplyWindow *self, ButtonId button, uint
     return;
   }
 
+  simply_res_set_image_pin(self->simply->res, &self->action_bar_icons[button], id);
   SimplyImage *icon = simply_res_auto_image(self->simply->res, id, true);
 
   if (!icon) {
@@ -207,6 +208,7 @@ void simply_window_action_bar_clear(SimplyWindow *self) {
 
   for (ButtonId button = BUTTON_ID_UP; button <= BUTTON_ID_DOWN; ++button) {
     action_bar_layer_clear_icon(self->action_bar_layer, button);
+    simply_res_set_image_pin(self->simply->res, &self->action_bar_icons[button], 0);
   }
 }
 
@@ -21,6 +21,8 @@ struct SimplyWindow {
   ActionBarLayer *action_bar_layer;
   const WindowHandlers *window_handlers;
   uint32_t id;
+  //! Image ids of the action bar icons, which stay pinned while the action bar draws their bitmaps
+  uint32_t action_bar_icons[NUM_BUTTONS];
   ButtonId button_mask:4;
   GColor8 background_color;
   bool is_fullscreen:1;
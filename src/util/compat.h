@@ -61,6 +61,10 @@ typedef union GColor8 {
 #define graphics_context_set_antialiased(ctx, enable)
 #endif
 
+#ifndef graphics_context_set_stroke_width
+#define graphics_context_set_stroke_width(ctx, width)
+#endif
+
 #ifndef gbitmap_create_from_png_data
 #define gbitmap_create_from_png_data(png_data, png_data_size) NULL
 #endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "util/framebuffer_kernels.h"
+#include "util/math.h"
+
+#include <pebble.h>
+
+#ifdef PBL_SDK_3
+
+typedef enum FramebufferEffect FramebufferEffect;
+
+enum FramebufferEffect {
+  FramebufferEffectInvert = 0,
+  FramebufferEffectDim,
+  FramebufferEffectTint,
+};
+
+static inline bool framebuffer_effect_is_light(GColor8 color) {
+  return (color.r + color.g + color.b) >= 5;
+}
+
+//! Picks the kernel for a 1-bit row. Dim and tint use a checkerboard so that half of the pixels
+//! are forced to black, or to white for a light tint.
+static inline FbKernelSpan framebuffer_effect_span1(FramebufferEffect effect, GColor8 tint, int16_t y,
+                                                    uint32_t *arg) {
+  *arg = (y & 1) ? 0xAAAAAAAAu : 0x55555555u;
+  switch (effect) {
+    case FramebufferEffectInvert: return fb_kernel_invert1_span;
+    case FramebufferEffectDim: return fb_kernel_and1_span;
+    case FramebufferEffectTint:
+      if (framebuffer_effect_is_light(tint)) {
+        return fb_kernel_or1_span;
+      }
+      return fb_kernel_and1_span;
+  }
+  return NULL;
+}
+
+static inline FbKernelSpan framebuffer_effect_span8(FramebufferEffect effect, GColor8 tint, uint32_t *arg) {
+  *arg = fb_kernel_splat(tint.argb);
+  switch (effect) {
+    case FramebufferEffectInvert: return fb_kernel_invert8_span;
+    case FramebufferEffectDim: return fb_kernel_dim8_span;
+    case FramebufferEffectTint: return fb_kernel_tint8_span;
+  }
+  return NULL;
+}
+
+//! Applies an effect in place to the pixels of a captured frame buffer inside rect,
+//! given in frame buffer coordinates.
+static inline void framebuffer_apply_effect(GBitmap *frame_buffer, GRect rect, FramebufferEffect effect,
+                                            GColor8 tint) {
+  const GRect bounds = gbitmap_get_bounds(frame_buffer);
+  const bool is_1bit = (gbitmap_get_format(frame_buffer) == GBitmapFormat1Bit);
+  const int16_t min_y = MAX(rect.origin.y, 0);
+  const int16_t max_y = MIN(rect.origin.y + rect.size.h, bounds.size.h);
+
+  uint32_t arg = 0;
+  FbKernelSpan span = is_1bit ? NULL : framebuffer_effect_span8(effect, tint, &arg);
+
+  for (int16_t y = min_y; y < max_y; y++) {
+#ifdef PBL_ROUND
+    // Round displays only store the visible range of each row
+    const GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, y);
+    uint8_t *row = info.data;
+    const int16_t min_x = MAX(rect.origin.x, info.min_x);
+    const int16_t end_x = MIN(rect.origin.x + rect.size.w, info.max_x + 1);
+#else
+    uint8_t *row = gbitmap_get_data(frame_buffer) + y * gbitmap_get_bytes_per_row(frame_buffer);
+    const int16_t min_x = MAX(rect.origin.x, 0);
+    const int16_t end_x = MIN(rect.origin.x + rect.size.w, bounds.size.w);
+#endif
+    if (is_1bit) {
+      span = framebuffer_effect_span1(effect, tint, y, &arg);
+      fb_kernel_row1(span, row, min_x, end_x, arg);
+    } else {
+      fb_kernel_row8(span, row, min_x, end_x, arg);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,108 @@
+#pragma once
+
+//! Pixel kernels for in-place framebuffer effects.
+//! These only depend on the C library so they can also be built and measured on the host.
+
+#include <stdint.h>
+
+//! 8-bit pixels are ARGB with two bits per channel. Effects preserve the alpha bits.
+#define FB_KERNEL_ALPHA_BITS 0xC0C0C0C0u
+#define FB_KERNEL_COLOR_BITS 0x3F3F3F3Fu
+#define FB_KERNEL_HIGH_BITS  0x2A2A2A2Au
+
+typedef uint32_t __attribute__((__may_alias__)) fb_kernel_word_t;
+
+//! Replicates a byte into every byte of a word
+static inline uint32_t fb_kernel_splat(uint8_t value) {
+  return value * 0x01010101u;
+}
+
+static inline uint32_t fb_kernel_invert8(uint32_t word, uint32_t arg) {
+  return word ^ FB_KERNEL_COLOR_BITS;
+}
+
+static inline uint32_t fb_kernel_dim8(uint32_t word, uint32_t arg) {
+  // Halving a two bit channel moves its high bit into its low bit
+  return (word & FB_KERNEL_ALPHA_BITS) | ((word & FB_KERNEL_HIGH_BITS) >> 1);
+}
+
+static inline uint32_t fb_kernel_tint8(uint32_t word, uint32_t arg) {
+  // Per-channel floor average of the pixel and the splatted tint color, which cannot carry
+  const uint32_t color = word & FB_KERNEL_COLOR_BITS;
+  const uint32_t tint = arg & FB_KERNEL_COLOR_BITS;
+  return (word & FB_KERNEL_ALPHA_BITS) | ((color & tint) + (((color ^ tint) & FB_KERNEL_HIGH_BITS) >> 1));
+}
+
+static inline uint32_t fb_kernel_invert1(uint32_t word, uint32_t arg) {
+  return ~word;
+}
+
+static inline uint32_t fb_kernel_and1(uint32_t word, uint32_t arg) {
+  return word & arg;
+}
+
+static inline uint32_t fb_kernel_or1(uint32_t word, uint32_t arg) {
+  return word | arg;
+}
+
+//! Defines a function applying a word kernel to the bytes [begin, end).
+//! Unaligned head and tail bytes go through the same kernel one byte at a time.
+#define FB_KERNEL_DEFINE_SPAN(name, kernel)                                          \
+  static inline void name(uint8_t *begin, uint8_t *end, uint32_t arg) {              \
+    uint8_t *data = begin;                                                           \
+    for (; data < end && ((uintptr_t) data & 3); data++) {                           \
+      *data = kernel(*data, arg);                                                    \
+    }                                                                                \
+    for (; data + 4 <= end; data += 4) {                                             \
+      *(fb_kernel_word_t *) data = kernel(*(fb_kernel_word_t *) data, arg);          \
+    }                                                                                \
+    for (; data < end; data++) {                                                     \
+      *data = kernel(*data, arg);                                                    \
+    }                                                                                \
+  }
+
+FB_KERNEL_DEFINE_SPAN(fb_kernel_invert8_span, fb_kernel_invert8)
+FB_KERNEL_DEFINE_SPAN(fb_kernel_dim8_span, fb_kernel_dim8)
+FB_KERNEL_DEFINE_SPAN(fb_kernel_tint8_span, fb_kernel_tint8)
+FB_KERNEL_DEFINE_SPAN(fb_kernel_invert1_span, fb_kernel_invert1)
+FB_KERNEL_DEFINE_SPAN(fb_kernel_and1_span, fb_kernel_and1)
+FB_KERNEL_DEFINE_SPAN(fb_kernel_or1_span, fb_kernel_or1)
+
+typedef void (*FbKernelSpan)(uint8_t *begin, uint8_t *end, uint32_t arg);
+
+//! Applies a span kernel to the pixels [min_x, end_x) of an 8-bit row
+static inline void fb_kernel_row8(FbKernelSpan span, uint8_t *row, int16_t min_x, int16_t end_x,
+                                  uint32_t arg) {
+  if (end_x > min_x) {
+    span(row + min_x, row + end_x, arg);
+  }
+}
+
+//! Applies a span kernel to the pixels [min_x, end_x) of a 1-bit row with the least significant
+//! bit first. Partial bytes at either end are merged through a mask.
+static inline void fb_kernel_row1(FbKernelSpan span, uint8_t *row, int16_t min_x, int16_t end_x,
+                                  uint32_t arg) {
+  if (end_x <= min_x) {
+    return;
+  }
+  const int16_t first = min_x >> 3;
+  const int16_t last = (end_x - 1) >> 3;
+  uint8_t head_mask = 0xFF << (min_x & 7);
+  const uint8_t tail_mask = 0xFF >> (7 - ((end_x - 1) & 7));
+  if (first == last) {
+    head_mask &= tail_mask;
+  }
+
+  uint8_t byte = row[first];
+  span(&byte, &byte + 1, arg);
+  row[first] = (row[first] & ~head_mask) | (byte & head_mask);
+  if (first == last) {
+    return;
+  }
+
+  span(row + first + 1, row + last, arg);
+
+  byte = row[last];
+  span(&byte, &byte + 1, arg);
+  row[last] = (row[last] & ~tail_mask) | (byte & tail_mask);
+}
@@ -2,7 +2,8 @@
 
 #include <pebble.h>
 
-#include "util/math.h"
+#include "util/color.h"
+#include "util/framebuffer_effects.h"
 
 #ifdef PBL_SDK_3
 
@@ -11,8 +12,9 @@ struct InverterLayer;
 
 static void inverter_layer_update_proc(Layer *layer, GContext *ctx) {
   GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
-  const size_t bytes_per_row = gbitmap_get_bytes_per_row(frame_buffer);
-  GColor8 *data = (GColor8 *)gbitmap_get_data(frame_buffer);
+  if (!frame_buffer) {
+    return;
+  }
 
   Layer *window_layer = window_get_root_layer(layer_get_window(layer));
   GRect window_bounds = layer_get_bounds(window_layer);
@@ -31,13 +33,8 @@ static void inverter_layer_update_proc(Layer *layer, GContext *ctx) {
   const int16_t max_x = MIN(drawing_box.size.w, min_x + frame.size.w);
   const int16_t max_y = MIN(drawing_box.size.h, min_y + frame.size.h);
 
-  data += bytes_per_row * min_y;
-  for (int16_t y = min_y; y < max_y; y++) {
-    for (int16_t x = min_x; x < max_x; x++) {
-      data[x] = (GColor8) { .argb = ~data[x].argb };
-    }
-    data += bytes_per_row;
-  }
+  framebuffer_apply_effect(frame_buffer, GRect(min_x, min_y, max_x - min_x, max_y - min_y),
+                           FramebufferEffectInvert, GColor8Black);
 
   graphics_release_frame_buffer(ctx, frame_buffer);
 }
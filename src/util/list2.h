@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+//! Doubly linked intrusive list with a tail pointer.
+//! Linking and unlinking a known node are O(1). Nodes start with next so that they can be walked
+//! the same way as List1Node lists.
+
+typedef struct List2Node List2Node;
+
+struct List2Node {
+  List2Node *next;
+  List2Node *prev;
+};
+
+typedef struct List2 List2;
+
+struct List2 {
+  List2Node *head;
+  List2Node *tail;
+};
+
+static inline bool list2_contains(List2 *list, List2Node *node) {
+  return (node->prev || list->head == node);
+}
+
+static inline List2Node *list2_insert_after(List2 *list, List2Node *prev, List2Node *node) {
+  node->prev = prev;
+  node->next = prev ? prev->next : list->head;
+  if (node->next) {
+    node->next->prev = node;
+  } else {
+    list->tail = node;
+  }
+  if (prev) {
+    prev->next = node;
+  } else {
+    list->head = node;
+  }
+  return node;
+}
+
+static inline List2Node *list2_insert_before(List2 *list, List2Node *next, List2Node *node) {
+  return list2_insert_after(list, next ? next->prev : list->tail, node);
+}
+
+static inline List2Node *list2_prepend(List2 *list, List2Node *node) {
+  return list2_insert_after(list, NULL, node);
+}
+
+static inline List2Node *list2_append(List2 *list, List2Node *node) {
+  return list2_insert_after(list, list->tail, node);
+}
+
+static inline List2Node *list2_get(List2 *list, int index) {
+  List2Node *walk = list->head;
+  for (int i = 0; walk && i < index; ++i) {
+    walk = walk->next;
+  }
+  return walk;
+}
+
+//! Inserts at an index, appending when the index is past the end
+static inline List2Node *list2_insert(List2 *list, int index, List2Node *node) {
+  return list2_insert_before(list, list2_get(list, index), node);
+}
+
+static inline List2Node *list2_remove(List2 *list, List2Node *node) {
+  if (!node || !list2_contains(list, node)) { return NULL; }
+  if (node->prev) {
+    node->prev->next = node->next;
+  } else {
+    list->head = node->next;
+  }
+  if (node->next) {
+    node->next->prev = node->prev;
+  } else {
+    list->tail = node->prev;
+  }
+  node->next = node->prev = NULL;
+  return node;
+}